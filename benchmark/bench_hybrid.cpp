@@ -220,3 +220,52 @@ static void BM_Hybrid_MulCTPT(benchmark::State& state) {
   for (auto _ : state) product = ct1 * pt2;
 }
 BENCHMARK(BM_Hybrid_MulCTPT)->Unit(benchmark::kMicrosecond)->Apply(customArgs);
+
+// (data_size, adaptive)
+static void mixedArgs(benchmark::internal::Benchmark* b) {
+  for (int i = INPUT_BN_NUM_MIN; i <= INPUT_BN_NUM_MAX;
+       i *= INPUT_BN_NUM_GROWTH_RATE) {
+    b->Args({i, 0});
+    b->Args({i, 1});
+  }
+}
+
+// Mixed encrypt/multiply/decrypt workload, OPTIMAL (0) vs ADAPTIVE (1) ratio
+static void BM_Hybrid_Mixed(benchmark::State& state) {
+  ipcl::setHybridOff();
+
+  int64_t dsize = state.range(0);
+  bool adaptive = state.range(1);
+
+  BigNumber n = P_BN * Q_BN;
+  int n_length = n.BitSize();
+  ipcl::PublicKey pk(n, n_length, Enable_DJN);
+  ipcl::PrivateKey sk(pk, P_BN, Q_BN);
+
+  std::vector<BigNumber> r_bn_v(dsize, R_BN);
+  pk.setRandom(r_bn_v);
+  pk.setHS(HS_BN);
+
+  std::vector<BigNumber> exp_bn1_v(dsize), exp_bn2_v(dsize);
+  for (int i = 0; i < dsize; i++) {
+    exp_bn1_v[i] = P_BN - BigNumber((unsigned int)(i * 1024));
+    exp_bn2_v[i] = Q_BN + BigNumber((unsigned int)(i * 1024));
+  }
+
+  ipcl::PlainText pt1(exp_bn1_v);
+  ipcl::PlainText pt2(exp_bn2_v);
+
+  if (adaptive) {
+    ipcl::HybridController::getInstance().reset();
+    ipcl::setHybridMode(ipcl::HybridMode::ADAPTIVE);
+  } else {
+    ipcl::setHybridMode(ipcl::HybridMode::OPTIMAL);
+  }
+
+  for (auto _ : state) {
+    ipcl::CipherText ct = pk.encrypt(pt1);
+    ipcl::CipherText product = ct * pt2;
+    ipcl::PlainText dt = sk.decrypt(product);
+  }
+}
+BENCHMARK(BM_Hybrid_Mixed)->Unit(benchmark::kMicrosecond)->Apply(mixedArgs);
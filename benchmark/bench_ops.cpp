@@ -123,6 +123,38 @@ BENCHMARK(BM_Add_CTPT)
     ->Unit(benchmark::kMicrosecond)
     ->ADD_SAMPLE_VECTOR_SIZE_ARGS;
 
+// Reference for BM_Add_CTPT: encrypt the plaintext without obfuscation and
+// add the ciphertexts
+static void BM_Add_CTPT_Encrypt(benchmark::State& state) {
+  size_t dsize = state.range(0);
+
+  BigNumber n = P_BN * Q_BN;
+  int n_length = n.BitSize();
+  ipcl::PublicKey pk(n, n_length, Enable_DJN);
+  ipcl::PrivateKey sk(pk, P_BN, Q_BN);
+
+  std::vector<BigNumber> r_bn_v(dsize, R_BN);
+  pk.setRandom(r_bn_v);
+  pk.setHS(HS_BN);
+
+  std::vector<BigNumber> exp_bn1_v(dsize), exp_bn2_v(dsize);
+  for (int i = 0; i < dsize; i++) {
+    exp_bn1_v[i] = P_BN - BigNumber((unsigned int)(i * 1024));
+    exp_bn2_v[i] = Q_BN + BigNumber((unsigned int)(i * 1024));
+  }
+
+  ipcl::PlainText pt1(exp_bn1_v);
+  ipcl::PlainText pt2(exp_bn2_v);
+
+  ipcl::CipherText ct1 = pk.encrypt(pt1);
+
+  ipcl::CipherText sum;
+  for (auto _ : state) sum = ct1 + pk.encrypt(pt2, false);
+}
+BENCHMARK(BM_Add_CTPT_Encrypt)
+    ->Unit(benchmark::kMicrosecond)
+    ->ADD_SAMPLE_VECTOR_SIZE_ARGS;
+
 static void BM_Mul_CTPT(benchmark::State& state) {
   size_t dsize = state.range(0);
   BigNumber n = P_BN * Q_BN;
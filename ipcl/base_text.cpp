@@ -3,6 +3,8 @@
 
 #include "ipcl/base_text.hpp"
 
+#include <utility>
+
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
@@ -21,11 +23,24 @@ BaseText::BaseText(const BigNumber& bn) : m_texts{bn}, m_size(1) {}
 BaseText::BaseText(const std::vector<BigNumber>& bn_v)
     : m_texts(bn_v), m_size(m_texts.size()) {}
 
+BaseText::BaseText(BigNumber&& bn) : m_size(1) {
+  m_texts.push_back(std::move(bn));
+}
+
+BaseText::BaseText(std::vector<BigNumber>&& bn_v)
+    : m_texts(std::move(bn_v)), m_size(m_texts.size()) {}
+
 BaseText::BaseText(const BaseText& bt) {
   this->m_texts = bt.getTexts();
   this->m_size = bt.getSize();
 }
 
+BaseText::BaseText(BaseText&& bt) noexcept
+    : m_texts(std::move(bt.m_texts)), m_size(bt.m_size) {
+  bt.m_texts.clear();
+  bt.m_size = 0;
+}
+
 BaseText& BaseText::operator=(const BaseText& other) {
   if (this == &other) return *this;
 
@@ -34,6 +49,16 @@ BaseText& BaseText::operator=(const BaseText& other) {
   return *this;
 }
 
+BaseText& BaseText::operator=(BaseText&& other) noexcept {
+  if (this == &other) return *this;
+
+  this->m_texts = std::move(other.m_texts);
+  this->m_size = other.m_size;
+  other.m_texts.clear();
+  other.m_size = 0;
+  return *this;
+}
+
 BigNumber& BaseText::operator[](const std::size_t idx) {
   ERROR_CHECK(idx < m_size, "BaseText:operator[] index is out of range");
 
@@ -64,12 +89,18 @@ void BaseText::remove(const std::size_t pos, const std::size_t length) {
   m_size = m_size - length;
 }
 
-BigNumber BaseText::getElement(const std::size_t& idx) const {
+const BigNumber& BaseText::getElement(const std::size_t& idx) const& {
   ERROR_CHECK(idx < m_size, "BaseText: getElement index is out of range");
 
   return m_texts[idx];
 }
 
+BigNumber BaseText::getElement(const std::size_t& idx) && {
+  ERROR_CHECK(idx < m_size, "BaseText: getElement index is out of range");
+
+  return std::move(m_texts[idx]);
+}
+
 std::vector<uint32_t> BaseText::getElementVec(const std::size_t& idx) const {
   ERROR_CHECK(idx < m_size, "BaseText: getElementVec index is out of range");
 
@@ -99,7 +130,12 @@ std::vector<BigNumber> BaseText::getChunk(const std::size_t& start,
   return v;
 }
 
-std::vector<BigNumber> BaseText::getTexts() const { return m_texts; }
+const std::vector<BigNumber>& BaseText::getTexts() const& { return m_texts; }
+
+std::vector<BigNumber> BaseText::getTexts() && {
+  m_size = 0;
+  return std::move(m_texts);
+}
 
 std::size_t BaseText::getSize() const { return m_size; }
 
@@ -16,9 +16,101 @@
 
 #include "ipcl/bignum.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <utility>
+
+#include "ipcl/utils/common.hpp"
+
+//////////////////////////////////////////////////////////////////////
+//
+// IppsBigNumState buffer cache
+//
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Per-thread free lists of IppsBigNumState buffers, grouped by power-of-two
+// word length, so that the temporaries of the arithmetic operators and the
+// copies into result vectors reuse memory instead of going to the heap.
+struct BNStatePool {
+  struct Node {
+    Node* next;
+  };
+  std::array<Node*, ipcl::IPCL_BIGNUM_POOL_CLASSES> head{};
+  std::array<int, ipcl::IPCL_BIGNUM_POOL_CLASSES> count{};
+  ~BNStatePool();
+};
+
+// trivially destructible, still readable once the pool has been destroyed
+thread_local bool t_pool_destroyed = false;
+thread_local BNStatePool t_pool;
+
+BNStatePool::~BNStatePool() {
+  t_pool_destroyed = true;
+  for (auto& node : head) {
+    while (node) {
+      Node* next = node->next;
+      delete[] reinterpret_cast<Ipp8u*>(node);
+      node = next;
+    }
+  }
+}
+
+// size class of a word length, -1 if too large to be cached
+int poolClass(int length) {
+  int c = 0;
+  while ((1 << c) < length) c++;
+  return c < ipcl::IPCL_BIGNUM_POOL_CLASSES ? c : -1;
+}
+
+int poolClassBytes(int c) {
+  static const auto bytes = [] {
+    std::array<int, ipcl::IPCL_BIGNUM_POOL_CLASSES> sizes;
+    for (int i = 0; i < ipcl::IPCL_BIGNUM_POOL_CLASSES; i++)
+      ippsBigNumGetSize(1 << i, &sizes[i]);
+    return sizes;
+  }();
+  return bytes[c];
+}
+
+Ipp8u* allocState(int length, int size) {
+  int c = poolClass(length);
+  if (c < 0) return new Ipp8u[size];
+
+  if (!t_pool_destroyed) {
+    BNStatePool& pool = t_pool;
+    if (BNStatePool::Node* node = pool.head[c]) {
+      pool.head[c] = node->next;
+      pool.count[c]--;
+      return reinterpret_cast<Ipp8u*>(node);
+    }
+  }
+  return new Ipp8u[poolClassBytes(c)];
+}
+
+void freeState(IppsBigNumState* pBN) {
+  if (!pBN) return;
+
+  int length;
+  ippsGetSize_BN(pBN, &length);
+  int c = poolClass(length);
+  if (c < 0 || t_pool_destroyed ||
+      t_pool.count[c] >= ipcl::IPCL_BIGNUM_POOL_DEPTH) {
+    delete[] reinterpret_cast<Ipp8u*>(pBN);
+    return;
+  }
+
+  auto node = reinterpret_cast<BNStatePool::Node*>(pBN);
+  node->next = t_pool.head[c];
+  t_pool.head[c] = node;
+  t_pool.count[c]++;
+}
+
+}  // namespace
 
 //////////////////////////////////////////////////////////////////////
 //
@@ -26,12 +118,12 @@
 //
 //////////////////////////////////////////////////////////////////////
 
-BigNumber::~BigNumber() { delete[](Ipp8u*) m_pBN; }
+BigNumber::~BigNumber() { freeState(m_pBN); }
 
 bool BigNumber::create(const Ipp32u* pData, int length, IppsBigNumSGN sgn) {
   int size;
   ippsBigNumGetSize(length, &size);
-  m_pBN = (IppsBigNumState*)(new Ipp8u[size]);
+  m_pBN = (IppsBigNumState*)allocState(length, size);
   if (!m_pBN) return false;
   ippsBigNumInit(length, m_pBN);
   if (pData) ippsSet_BN(sgn, length, pData, m_pBN);
@@ -101,6 +193,11 @@ BigNumber::BigNumber(const BigNumber& bn) {
   create(bnData, BITSIZE_WORD(bnBitLen), bnSgn);
 }
 
+// steal the state, the moved-from object gets a zero state on its next use
+BigNumber::BigNumber(BigNumber&& bn) noexcept : m_pBN(bn.m_pBN) {
+  bn.m_pBN = nullptr;
+}
+
 //
 // set value
 //
@@ -137,12 +234,26 @@ BigNumber& BigNumber::operator=(const BigNumber& bn) {
     Ipp32u* bnData;
     ippsRef_BN(&bnSgn, &bnBitLen, &bnData, bn);
 
-    delete[](Ipp8u*) m_pBN;
-    create(bnData, BITSIZE_WORD(bnBitLen), bnSgn);
+    // reuse the current buffer when it has enough room
+    int length = std::max(BITSIZE_WORD(bnBitLen), 1);
+    int room = 0;
+    if (m_pBN) ippsGetSize_BN(m_pBN, &room);
+    if (room >= length) {
+      ippsSet_BN(bnSgn, length, bnData, m_pBN);
+    } else {
+      freeState(m_pBN);
+      create(bnData, length, bnSgn);
+    }
   }
   return *this;
 }
 
+// swap the states, the previous buffer is released with the moved-from object
+BigNumber& BigNumber::operator=(BigNumber&& bn) noexcept {
+  std::swap(m_pBN, bn.m_pBN);
+  return *this;
+}
+
 BigNumber& BigNumber::operator+=(const BigNumber& bn) {
   int aBitLen;
   ippsRef_BN(nullptr, &aBitLen, nullptr, *this);
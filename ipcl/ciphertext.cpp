@@ -4,29 +4,58 @@
 #include "ipcl/ciphertext.hpp"
 
 #include <algorithm>
+#include <utility>
 
 #include "ipcl/mod_exp.hpp"
+#include "ipcl/mod_mul.hpp"
+#include "ipcl/mod_prod.hpp"
+#include "ipcl/multi_exp.hpp"
+#include "ipcl/utils/executor.hpp"
+#include "ipcl/utils/mont_cache.hpp"
 
 namespace ipcl {
 CipherText::CipherText(const PublicKey& pk, const uint32_t& n)
-    : BaseText(n), m_pk(std::make_shared<PublicKey>(pk)) {}
+    : BaseText(n), m_pk(pk.getHandle()) {}
 
 CipherText::CipherText(const PublicKey& pk, const std::vector<uint32_t>& n_v)
-    : BaseText(n_v), m_pk(std::make_shared<PublicKey>(pk)) {}
+    : BaseText(n_v), m_pk(pk.getHandle()) {}
 
 CipherText::CipherText(const PublicKey& pk, const BigNumber& bn)
-    : BaseText(bn), m_pk(std::make_shared<PublicKey>(pk)) {}
+    : BaseText(bn), m_pk(pk.getHandle()) {}
 
 CipherText::CipherText(const PublicKey& pk, const std::vector<BigNumber>& bn_v)
-    : BaseText(bn_v), m_pk(std::make_shared<PublicKey>(pk)) {}
+    : BaseText(bn_v), m_pk(pk.getHandle()) {}
+
+CipherText::CipherText(const PublicKey& pk, BigNumber&& bn)
+    : BaseText(std::move(bn)), m_pk(pk.getHandle()) {}
+
+CipherText::CipherText(const PublicKey& pk, std::vector<BigNumber>&& bn_v)
+    : BaseText(std::move(bn_v)), m_pk(pk.getHandle()) {}
+
+CipherText::CipherText(std::shared_ptr<const PublicKey> pk,
+                       std::vector<BigNumber>&& bn_v, bool mont)
+    : BaseText(std::move(bn_v)), m_pk(std::move(pk)), m_mont(mont) {}
 
 CipherText::CipherText(const CipherText& ct) : BaseText(ct) {
   this->m_pk = ct.m_pk;
+  this->m_mont = ct.m_mont;
 }
 
 CipherText& CipherText::operator=(const CipherText& other) {
   BaseText::operator=(other);
   this->m_pk = other.m_pk;
+  this->m_mont = other.m_mont;
+
+  return *this;
+}
+
+CipherText::CipherText(CipherText&& ct) noexcept
+    : BaseText(std::move(ct)), m_pk(std::move(ct.m_pk)), m_mont(ct.m_mont) {}
+
+CipherText& CipherText::operator=(CipherText&& other) noexcept {
+  BaseText::operator=(std::move(other));
+  this->m_pk = std::move(other.m_pk);
+  this->m_mont = other.m_mont;
 
   return *this;
 }
@@ -36,15 +65,23 @@ CipherText CipherText::operator+(const CipherText& other) const {
   std::size_t b_size = other.getSize();
   ERROR_CHECK(this->m_size == b_size || b_size == 1,
               "CT + CT error: Size mismatch!");
-  ERROR_CHECK(*(m_pk->getN()) == *(other.m_pk->getN()),
+  // keys of the same n, with or without DJN, share the ciphertext space
+  ERROR_CHECK(m_pk == other.m_pk || *(m_pk->getN()) == *(other.m_pk->getN()),
               "CT + CT error: 2 different public keys detected!");
 
+  // bring other into the domain of this
+  if (other.m_mont != m_mont)
+    return *this + (m_mont ? other.toMontgomery() : other.fromMontgomery());
+
   const auto& a = *this;
   const auto& b = other;
 
   if (m_size == 1) {
-    BigNumber sum = a.raw_add(a.m_texts.front(), b.getTexts().front());
-    return CipherText(*m_pk, sum);
+    std::vector<BigNumber> sum{a.raw_add(a.m_texts.front(), b.m_texts.front())};
+    return CipherText(m_pk, std::move(sum), m_mont);
+  } else if (!m_mont) {
+    // batched on the multi-buffer kernel
+    return CipherText(m_pk, modMul(a.m_texts, b.m_texts, *(m_pk->getNSQ())));
   } else {
     std::vector<BigNumber> sum(m_size);
 
@@ -67,16 +104,33 @@ CipherText CipherText::operator+(const CipherText& other) const {
       for (std::size_t i = 0; i < m_size; i++)
         sum[i] = a.raw_add(a.m_texts[i], b.m_texts[i]);
     }
-    return CipherText(*m_pk, sum);
+    return CipherText(m_pk, std::move(sum), m_mont);
   }
 }
 
 // CT + PT
 CipherText CipherText::operator+(const PlainText& other) const {
-  // convert PT to CT
-  CipherText b = this->m_pk->encrypt(other, false);
-  // calculate CT + CT
-  return this->operator+(b);
+  std::size_t b_size = other.getSize();
+  ERROR_CHECK(this->m_size == b_size || b_size == 1,
+              "CT + PT error: Size mismatch!");
+
+  // with g = n + 1, c * g^m = c * (1 + m * n) = c + n * (c * m mod n) mod n^2,
+  // a product mod n instead of an encryption and a product mod n^2. It is
+  // linear in c, so it holds in the Montgomery domain as well.
+  const BigNumber& n = *(m_pk->getN());
+  const BigNumber& sq = *(m_pk->getNSQ());
+  std::vector<BigNumber> sum = modMul(m_texts, other.getTexts(), n);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, m_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < m_size; i++) {
+    sum[i] = m_texts[i] + n * sum[i];
+    if (sum[i] >= sq) sum[i] -= sq;
+  }
+  return CipherText(m_pk, std::move(sum), m_mont);
 }
 
 // CT * PT
@@ -85,34 +139,48 @@ CipherText CipherText::operator*(const PlainText& other) const {
   ERROR_CHECK(this->m_size == b_size || b_size == 1,
               "CT * PT error: Size mismatch!");
 
+  // the exponentiation converts into its own Montgomery domain
+  if (m_mont) return (fromMontgomery() * other).toMontgomery();
+
   const auto& a = *this;
   const auto& b = other;
 
   if (m_size == 1) {
-    BigNumber product = a.raw_mul(a.m_texts.front(), b.getTexts().front());
-    return CipherText(*m_pk, product);
+    std::vector<BigNumber> product{
+        a.raw_mul(a.m_texts.front(), b.getTexts().front())};
+    return CipherText(m_pk, std::move(product));
   } else {
     std::vector<BigNumber> product;
     if (b_size == 1) {
       // multiply vector by scalar
-      std::vector<BigNumber> b_v(a.m_size, b.getElement(0));
-      product = a.raw_mul(a.m_texts, b_v);
+      product = a.raw_mul(a.m_texts, b.getTexts().front());
     } else {
       // multiply vector by vector
       product = a.raw_mul(a.m_texts, b.getTexts());
     }
-    return CipherText(*m_pk, product);
+    return CipherText(m_pk, std::move(product));
   }
 }
 
+std::future<CipherText> CipherText::multiplyAsync(
+    const PlainText& other) const {
+  HybridParams params = getHybridParams();
+  return Executor::getDefault().submit([params, ct = *this, other] {
+    setHybridParams(params);
+    return ct * other;
+  });
+}
+
 CipherText CipherText::getCipherText(const size_t& idx) const {
   ERROR_CHECK((idx >= 0) && (idx < m_size),
               "CipherText::getCipherText index is out of range");
 
-  return CipherText(*m_pk, m_texts[idx]);
+  return CipherText(m_pk, {m_texts[idx]}, m_mont);
 }
 
-std::shared_ptr<PublicKey> CipherText::getPubKey() const { return m_pk; }
+std::shared_ptr<const PublicKey> CipherText::getPubKey() const {
+  return m_pk;
+}
 
 CipherText CipherText::rotate(int shift) const {
   ERROR_CHECK(m_size != 1, "rotate: Cannot rotate single CipherText");
@@ -120,7 +188,7 @@ CipherText CipherText::rotate(int shift) const {
               "rotate: Cannot shift more than the test size");
 
   if (shift == 0 || shift == m_size || shift == (-1) * static_cast<int>(m_size))
-    return CipherText(*m_pk, m_texts);
+    return CipherText(m_pk, std::vector<BigNumber>(m_texts), m_mont);
 
   if (shift > 0)
     shift = m_size - shift;
@@ -129,10 +197,53 @@ CipherText CipherText::rotate(int shift) const {
 
   std::vector<BigNumber> new_bn = getTexts();
   std::rotate(std::begin(new_bn), std::begin(new_bn) + shift, std::end(new_bn));
-  return CipherText(*m_pk, new_bn);
+  return CipherText(m_pk, std::move(new_bn), m_mont);
+}
+
+CipherText CipherText::sum() const { return sum(m_size); }
+
+CipherText CipherText::sum(std::size_t block_size) const {
+  ERROR_CHECK(m_size > 0, "sum: CipherText is empty");
+
+  return CipherText(
+      m_pk, modProd(m_texts, block_size, *(m_pk->getNSQ()), m_mont), m_mont);
+}
+
+CipherText CipherText::toMontgomery() const {
+  if (m_mont) return *this;
+
+  const BigNumber& sq = *(m_pk->getNSQ());
+  std::vector<BigNumber> mont_v(m_size);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, m_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < m_size; i++) mont_v[i] = toMontForm(m_texts[i], sq);
+
+  return CipherText(m_pk, std::move(mont_v), true);
+}
+
+CipherText CipherText::fromMontgomery() const {
+  if (!m_mont) return *this;
+
+  const BigNumber& sq = *(m_pk->getNSQ());
+  std::vector<BigNumber> bn_v(m_size);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, m_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < m_size; i++) bn_v[i] = fromMontForm(m_texts[i], sq);
+
+  return CipherText(m_pk, std::move(bn_v));
 }
 
 BigNumber CipherText::raw_add(const BigNumber& a, const BigNumber& b) const {
+  if (m_mont) return montMul(a, b, *(m_pk->getNSQ()));
+
   // Hold a copy of nsquare for multi-threaded
   // The BigNumber % operator is not thread safe
   // const BigNumber& sq = *(m_pk->getNSQ());
@@ -145,20 +256,42 @@ BigNumber CipherText::raw_mul(const BigNumber& a, const BigNumber& b) const {
   return modExp(a, b, sq);
 }
 
-std::vector<BigNumber> CipherText::raw_mul(
-    const std::vector<BigNumber>& a, const std::vector<BigNumber>& b) const {
-  std::size_t v_size = a.size();
-  std::vector<BigNumber> sq(v_size, *(m_pk->getNSQ()));
-
-  // If hybrid OPTIMAL mode is used, use a special ratio
+// If hybrid OPTIMAL mode is used, use a special ratio
+static void setMultiplyHybridRatio(std::size_t v_size) {
   if (isHybridOptimal()) {
     float qat_ratio = (v_size <= IPCL_WORKLOAD_SIZE_THRESHOLD)
                           ? IPCL_HYBRID_MODEXP_RATIO_FULL
                           : IPCL_HYBRID_MODEXP_RATIO_MULTIPLY;
     setHybridRatio(qat_ratio, false);
   }
+}
 
-  return modExp(a, b, sq);
+std::vector<BigNumber> CipherText::raw_mul(
+    const std::vector<BigNumber>& a, const std::vector<BigNumber>& b) const {
+  HybridOpScope hybrid_op(HybridOp::MULTIPLY);
+  setMultiplyHybridRatio(a.size());
+
+  return modExp(a, b, *(m_pk->getNSQ()));
+}
+
+std::vector<BigNumber> CipherText::raw_mul(const std::vector<BigNumber>& a,
+                                           const BigNumber& b) const {
+  HybridOpScope hybrid_op(HybridOp::MULTIPLY);
+  setMultiplyHybridRatio(a.size());
+
+  // the shared pow reaches the fixed-exponent and broadcast paths of modExp
+  return modExp(a, b, *(m_pk->getNSQ()));
+}
+
+CipherText innerProduct(const CipherText& ct, const PlainText& pt) {
+  ERROR_CHECK(ct.getSize() == pt.getSize() && ct.getSize() > 0,
+              "innerProduct: Size mismatch!");
+  if (ct.isMontgomery())
+    return innerProduct(ct.fromMontgomery(), pt).toMontgomery();
+
+  std::shared_ptr<const PublicKey> pk = ct.getPubKey();
+  BigNumber res = multiExp(ct.getTexts(), pt.getTexts(), *(pk->getNSQ()));
+  return CipherText(*pk, std::move(res));
 }
 
 }  // namespace ipcl
@@ -0,0 +1,170 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/encoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+// Or the low bits of v into words at bit position pos
+static void setBits(std::vector<Ipp32u>& words, std::size_t pos, Ipp64u v) {
+  std::size_t idx = pos >> 5;
+  int shift = pos & 31;
+  words[idx] |= static_cast<Ipp32u>(v << shift);
+  words[idx + 1] |= static_cast<Ipp32u>(v >> (32 - shift));
+  if (shift > 0) words[idx + 2] |= static_cast<Ipp32u>(v >> (64 - shift));
+}
+
+// Read bits bits of words at bit position pos
+static Ipp64u getBits(const Ipp32u* words, std::size_t size, std::size_t pos,
+                      int bits) {
+  std::size_t idx = pos >> 5;
+  int shift = pos & 31;
+  Ipp64u v = 0;
+  if (idx < size) v = static_cast<Ipp64u>(words[idx]) >> shift;
+  if (idx + 1 < size) v |= static_cast<Ipp64u>(words[idx + 1]) << (32 - shift);
+  if (shift > 0 && idx + 2 < size)
+    v |= static_cast<Ipp64u>(words[idx + 2]) << (64 - shift);
+  return v & ((1ULL << bits) - 1);
+}
+
+Encoder::Encoder(const PublicKey& pk, int value_bits, int headroom_bits,
+                 int frac_bits)
+    : m_value_bits(value_bits),
+      m_slot_bits(value_bits + headroom_bits),
+      m_frac_bits(frac_bits) {
+  ERROR_CHECK(pk.isInitialized(), "Encoder: Public key is NOT initialized.");
+  ERROR_CHECK(value_bits > 0 && headroom_bits >= 0 && frac_bits >= 0,
+              "Encoder: bit lengths should be non-negative");
+  ERROR_CHECK(m_slot_bits <= IPCL_ENCODER_MAX_SLOT_BITS,
+              "Encoder: value and headroom bits exceed the slot limit");
+  ERROR_CHECK(frac_bits < value_bits,
+              "Encoder: fractional bits should be less than value bits");
+
+  m_n = *pk.getN();
+  m_half_n = m_n / BigNumber::Two();
+
+  // |sum(x_i * 2^(slot_bits * i))| < 2^(slots * slot_bits - 1) <= n / 2
+  m_slots = (m_n.BitSize() - 1) / m_slot_bits;
+  ERROR_CHECK(m_slots > 0, "Encoder: slot is wider than the modulus");
+}
+
+BigNumber Encoder::pack(const int64_t* v, std::size_t count) const {
+  // x_i = u_i - b_i * 2^slot_bits with u_i = x_i mod 2^slot_bits, so the
+  // signed sum is U - B for the non-negative U = sum(u_i * 2^(slot_bits * i))
+  // and B = sum(b_i * 2^(slot_bits * (i + 1)))
+  std::size_t words = m_slots * m_slot_bits / 32 + 3;
+  std::vector<Ipp32u> u(words, 0), b(words, 0);
+  const Ipp64u slot_mask = (1ULL << m_slot_bits) - 1;
+
+  for (std::size_t i = 0; i < count; i++) {
+    setBits(u, i * m_slot_bits, static_cast<Ipp64u>(v[i]) & slot_mask);
+    if (v[i] < 0) setBits(b, (i + 1) * m_slot_bits, 1);
+  }
+
+  BigNumber u_bn(u.data(), words, IppsBigNumPOS);
+  BigNumber b_bn(b.data(), words, IppsBigNumPOS);
+  if (u_bn >= b_bn) return u_bn - b_bn;
+  return m_n - (b_bn - u_bn);
+}
+
+void Encoder::unpack(const BigNumber& bn, int64_t* v,
+                     std::size_t count) const {
+  // elements above n/2 are negative sums, decoded from their magnitude
+  BigNumber p = (bn >= m_n) ? bn % m_n : bn;
+  bool negative = (p > m_half_n);
+  if (negative) p = m_n - p;
+
+  int bits;
+  Ipp32u* data;
+  ippsRef_BN(nullptr, &bits, &data, BN(p));
+  int size = BITSIZE_WORD(bits);
+
+  // signed digits within [-2^(slot_bits - 1), 2^(slot_bits - 1)), the
+  // magnitude of a negative sum takes the digits with the opposite bound
+  const Ipp64u half = 1ULL << (m_slot_bits - 1);
+  const int64_t slot = 1LL << m_slot_bits;
+  Ipp64u carry = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    Ipp64u digit = getBits(data, size, i * m_slot_bits, m_slot_bits) + carry;
+    bool wrap = negative ? (digit > half) : (digit >= half);
+    int64_t x = static_cast<int64_t>(digit) - (wrap ? slot : 0);
+    carry = wrap ? 1 : 0;
+    v[i] = negative ? -x : x;
+  }
+}
+
+PlainText Encoder::encode(const std::vector<int64_t>& v) const {
+  ERROR_CHECK(!v.empty(), "Encoder: Cannot encode empty vector");
+
+  const int64_t bound = 1LL << (m_value_bits - 1);
+  for (int64_t x : v)
+    ERROR_CHECK(x >= -bound && x < bound,
+                "Encoder: value exceeds the value bit length");
+
+  std::size_t count = v.size();
+  std::size_t num_elements = (count + m_slots - 1) / m_slots;
+  std::vector<BigNumber> bn_v(num_elements);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_elements))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < num_elements; i++) {
+    std::size_t begin = i * m_slots;
+    bn_v[i] = pack(&v[begin], std::min<std::size_t>(m_slots, count - begin));
+  }
+  return PlainText(std::move(bn_v));
+}
+
+PlainText Encoder::encode(const std::vector<double>& v) const {
+  const double scale = std::ldexp(1.0, m_frac_bits);
+  const double bound = std::ldexp(1.0, m_value_bits - 1);
+
+  std::vector<int64_t> scaled(v.size());
+  for (std::size_t i = 0; i < v.size(); i++) {
+    double x = std::round(v[i] * scale);
+    ERROR_CHECK(x >= -bound && x < bound,
+                "Encoder: value exceeds the value bit length");
+    scaled[i] = static_cast<int64_t>(x);
+  }
+  return encode(scaled);
+}
+
+std::vector<int64_t> Encoder::decodeInt(const PlainText& pt,
+                                        std::size_t count) const {
+  std::size_t num_elements = (count + m_slots - 1) / m_slots;
+  ERROR_CHECK(pt.getSize() >= num_elements,
+              "Encoder: PlainText holds fewer values than requested");
+
+  std::vector<int64_t> v(count);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_elements))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < num_elements; i++) {
+    std::size_t begin = i * m_slots;
+    unpack(pt.getElement(i), &v[begin],
+           std::min<std::size_t>(m_slots, count - begin));
+  }
+  return v;
+}
+
+std::vector<double> Encoder::decodeDouble(const PlainText& pt,
+                                          std::size_t count) const {
+  std::vector<int64_t> scaled = decodeInt(pt, count);
+
+  std::vector<double> v(count);
+  for (std::size_t i = 0; i < count; i++)
+    v[i] = std::ldexp(static_cast<double>(scaled[i]), -m_frac_bits);
+  return v;
+}
+
+}  // namespace ipcl
@@ -0,0 +1,199 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/fixed_base_exp.hpp"
+
+#include <algorithm>
+
+#include "ipcl/mod_exp.hpp"
+#include "ipcl/utils/mont_cache.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+constexpr int FIXED_BASE_WINDOW_MAX = 8;
+
+// Pick the window size minimizing the number of multiplications of the
+// bucket method: one per window digit plus two per nonzero digit value.
+static int chooseWindowBits(int exp_bits) {
+  int best_w = 1;
+  int best_cost = exp_bits + 2;
+  for (int w = 2; w <= FIXED_BASE_WINDOW_MAX; w++) {
+    int cost = (exp_bits + w - 1) / w + 2 * ((1 << w) - 1);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_w = w;
+    }
+  }
+  return best_w;
+}
+
+static int getWindowDigit(const Ipp32u* data, int words, int bit_pos,
+                          int w) {
+  int idx = bit_pos >> 5;
+  int shift = bit_pos & 31;
+  if (idx >= words) return 0;
+  Ipp64u digit = data[idx] >> shift;
+  if ((shift + w > 32) && (idx + 1 < words))
+    digit |= static_cast<Ipp64u>(data[idx + 1]) << (32 - shift);
+  return static_cast<int>(digit & ((1u << w) - 1));
+}
+
+// Copy bucket idx of words words each into res, reading every bucket so that
+// the memory access pattern does not depend on idx
+static void selectBucket(Ipp32u* res, const Ipp32u* buckets, int n_buckets,
+                         int idx, int words) {
+  std::fill(res, res + words, 0);
+  for (int d = 0; d < n_buckets; d++) {
+    Ipp32u mask = 0u - static_cast<Ipp32u>(d == idx);
+    const Ipp32u* bucket = buckets + d * words;
+    for (int k = 0; k < words; k++) res[k] |= bucket[k] & mask;
+  }
+}
+
+// Store val into bucket idx, writing every bucket
+static void storeBucket(Ipp32u* buckets, int n_buckets, int idx,
+                        const Ipp32u* val, int words) {
+  for (int d = 0; d < n_buckets; d++) {
+    Ipp32u mask = 0u - static_cast<Ipp32u>(d == idx);
+    Ipp32u* bucket = buckets + d * words;
+    for (int k = 0; k < words; k++)
+      bucket[k] = (val[k] & mask) | (bucket[k] & ~mask);
+  }
+}
+
+// Copy a big number into a zero-padded buffer of words words
+static void toWords(const BigNumber& bn, Ipp32u* out, int words) {
+  int bits;
+  Ipp32u* data;
+  ippsRef_BN(nullptr, &bits, &data, BN(bn));
+  int len = BITSIZE_WORD(bits);
+  std::copy(data, data + len, out);
+  std::fill(out + len, out + words, 0);
+}
+
+FixedBaseModExp::FixedBaseModExp(const BigNumber& base, const BigNumber& mod,
+                                 int max_exp_bits)
+    : m_window_bits(chooseWindowBits(max_exp_bits)),
+      m_max_exp_bits(max_exp_bits),
+      m_base(base % mod),
+      m_mod(mod),
+      m_mont_one(mod) {
+  ERROR_CHECK(max_exp_bits > 0,
+              "FixedBaseModExp: max exponent bit length should be positive");
+  ERROR_CHECK(mod.IsOdd(), "FixedBaseModExp: modulus should be odd");
+
+  IppsMontState* pMont = getMontState(m_mod);
+
+  IppStatus stat = ippsMontForm(BN(BigNumber::One()), pMont, BN(m_mont_one));
+  ERROR_CHECK(stat == ippStsNoErr,
+              "FixedBaseModExp: convert big number into Mont form error.");
+
+  // powers[i] = base^(2^(w*i)), kept in Montgomery form
+  int n_windows = (max_exp_bits + m_window_bits - 1) / m_window_bits;
+  m_powers.reserve(n_windows);
+
+  BigNumber power(mod);
+  stat = ippsMontForm(BN(m_base), pMont, BN(power));
+  ERROR_CHECK(stat == ippStsNoErr,
+              "FixedBaseModExp: convert big number into Mont form error.");
+  m_powers.push_back(power);
+
+  for (int i = 1; i < n_windows; i++) {
+    for (int j = 0; j < m_window_bits; j++) {
+      stat = ippsMontMul(BN(power), BN(power), pMont, BN(power));
+      ERROR_CHECK(stat == ippStsNoErr,
+                  std::string("ippsMontMul: error code = ") +
+                      std::to_string(stat));
+    }
+    m_powers.push_back(power);
+  }
+}
+
+BigNumber FixedBaseModExp::exp(const BigNumber& pow) const {
+  IppsBigNumSGN pow_sgn;
+  int pow_bits;
+  Ipp32u* pow_data;
+  ippsRef_BN(&pow_sgn, &pow_bits, &pow_data, BN(pow));
+
+  if (pow_sgn == IppsBigNumNEG || pow_bits > m_max_exp_bits)
+    return modExp(m_base, pow, m_mod);
+
+  // Every window of the table is visited whatever the length of pow, which
+  // may be secret (e.g. the DJN randomness)
+  int w = m_window_bits;
+  int pow_words = BITSIZE_WORD(pow_bits);
+  int n_digits = m_powers.size();
+  std::vector<int> digits(n_digits);
+  for (int i = 0; i < n_digits; i++)
+    digits[i] = getWindowDigit(pow_data, pow_words, i * w, w);
+
+  IppsMontState* pMont = getMontState(m_mod);
+
+  // Bucket method: bucket d accumulates the powers whose digit is d, in the
+  // order of the windows. The bucket of each digit is read and written with
+  // a masked scan of all the buckets, so that neither the multiplications
+  // nor the memory accesses depend on the digits. The powers of the zero
+  // digits go to bucket 0, which is discarded.
+  int n_buckets = 1 << w;
+  int words = BITSIZE_WORD(m_mod.BitSize());
+  std::vector<Ipp32u> buckets(n_buckets * words);
+  std::vector<Ipp32u> val(words);
+  toWords(m_mont_one, val.data(), words);
+  for (int d = 0; d < n_buckets; d++)
+    std::copy(val.begin(), val.end(), buckets.begin() + d * words);
+
+  IppStatus stat = ippStsNoErr;
+  BigNumber acc(m_mod);
+  for (int i = 0; i < n_digits; i++) {
+    selectBucket(val.data(), buckets.data(), n_buckets, digits[i], words);
+    acc.Set(val.data(), words);
+    stat = ippsMontMul(BN(acc), BN(m_powers[i]), pMont, BN(acc));
+    ERROR_CHECK(stat == ippStsNoErr,
+                std::string("ippsMontMul: error code = ") +
+                    std::to_string(stat));
+    toWords(acc, val.data(), words);
+    storeBucket(buckets.data(), n_buckets, digits[i], val.data(), words);
+  }
+
+  // a = prod bucket[d]^d, with b accumulating the buckets of digits >= d
+  BigNumber a(m_mod), b(m_mod), bucket(m_mod);
+  toWords(m_mont_one, val.data(), words);
+  a.Set(val.data(), words);
+  b.Set(val.data(), words);
+  for (int d = n_buckets - 1; d > 0; d--) {
+    bucket.Set(buckets.data() + d * words, words);
+    stat = ippsMontMul(BN(b), BN(bucket), pMont, BN(b));
+    ERROR_CHECK(stat == ippStsNoErr,
+                std::string("ippsMontMul: error code = ") +
+                    std::to_string(stat));
+    stat = ippsMontMul(BN(a), BN(b), pMont, BN(a));
+    ERROR_CHECK(stat == ippStsNoErr,
+                std::string("ippsMontMul: error code = ") +
+                    std::to_string(stat));
+  }
+
+  // convert out of Montgomery form
+  BigNumber res(m_mod);
+  stat = ippsMontMul(BN(a), BN(BigNumber::One()), pMont, BN(res));
+  ERROR_CHECK(stat == ippStsNoErr,
+              std::string("ippsMontMul: error code = ") + std::to_string(stat));
+  return res;
+}
+
+std::vector<BigNumber> FixedBaseModExp::exp(
+    const std::vector<BigNumber>& pow) const {
+  std::size_t v_size = pow.size();
+  std::vector<BigNumber> res(v_size);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < v_size; i++) res[i] = exp(pow[i]);
+
+  return res;
+}
+
+}  // namespace ipcl
@@ -0,0 +1,146 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/fixed_exponent_exp.hpp"
+
+#include <algorithm>
+
+#include "ipcl/utils/mont_cache.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+constexpr int FIXED_EXP_WINDOW_MAX = 6;
+
+// Pick the window size minimizing the multiplications of the fixed window
+// method: 2^w table entries per base plus one per w bits.
+static int chooseWindowBits(int exp_bits) {
+  int best_w = 1;
+  int best_cost = exp_bits + 2;
+  for (int w = 2; w <= FIXED_EXP_WINDOW_MAX; w++) {
+    int cost = (1 << w) + (exp_bits + w - 1) / w;
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_w = w;
+    }
+  }
+  return best_w;
+}
+
+static inline int testBit(const Ipp32u* data, int bit_pos) {
+  return (data[bit_pos >> 5] >> (bit_pos & 31)) & 1;
+}
+
+static void checkMontStatus(IppStatus stat) {
+  ERROR_CHECK(stat == ippStsNoErr,
+              std::string("ippsMontMul: error code = ") + std::to_string(stat));
+}
+
+// Copy a big number into words, zero padded
+static void storeEntry(const BigNumber& bn, Ipp32u* out) {
+  int bits;
+  Ipp32u* data;
+  ippsRef_BN(nullptr, &bits, &data, BN(bn));
+  std::copy(data, data + BITSIZE_WORD(bits), out);
+}
+
+// Copy table entry d into out, reading every entry so that the memory access
+// pattern does not depend on the (secret) digit
+static void selectEntry(const std::vector<Ipp32u>& table, int words,
+                        int entries, int d, Ipp32u* out) {
+  std::fill(out, out + words, 0);
+  for (int e = 0; e < entries; e++) {
+    Ipp32u mask = 0 - static_cast<Ipp32u>(e == d);
+    const Ipp32u* entry = table.data() + e * words;
+    for (int k = 0; k < words; k++) out[k] |= entry[k] & mask;
+  }
+}
+
+FixedExpModExp::FixedExpModExp(const BigNumber& exp, const BigNumber& mod)
+    : m_mod(mod) {
+  ERROR_CHECK(mod.IsOdd(), "FixedExpModExp: modulus should be odd");
+
+  IppsBigNumSGN exp_sgn;
+  int exp_bits;
+  Ipp32u* exp_data;
+  ippsRef_BN(&exp_sgn, &exp_bits, &exp_data, BN(exp));
+  ERROR_CHECK(exp_sgn == IppsBigNumPOS,
+              "FixedExpModExp: exponent should be non-negative");
+
+  m_window_bits = chooseWindowBits(exp_bits);
+
+  // w-bit digits from the most significant window, zero digits included
+  int n_windows = (exp_bits + m_window_bits - 1) / m_window_bits;
+  m_digits.resize(n_windows);
+  for (int k = 0; k < n_windows; k++) {
+    int low = (n_windows - 1 - k) * m_window_bits;
+    int high = std::min(low + m_window_bits, exp_bits);
+    int value = 0;
+    for (int j = high - 1; j >= low; j--)
+      value = (value << 1) | testBit(exp_data, j);
+    m_digits[k] = value;
+  }
+}
+
+BigNumber FixedExpModExp::exp(const BigNumber& base) const {
+  if (m_digits.empty()) return BigNumber::One();
+
+  IppsMontState* pMont = getMontState(m_mod);
+  IppStatus stat = ippStsNoErr;
+
+  int mod_bits;
+  ippsRef_BN(nullptr, &mod_bits, nullptr, BN(m_mod));
+  const int words = BITSIZE_WORD(mod_bits);
+  const int entries = 1 << m_window_bits;
+
+  // table[e] = base^e in Montgomery form, table[0] = 1
+  std::vector<Ipp32u> table(entries * words, 0);
+  BigNumber x(m_mod), power(m_mod);
+  stat = ippsMontForm(BN(base), pMont, BN(x));
+  ERROR_CHECK(stat == ippStsNoErr,
+              "FixedExpModExp: convert big number into Mont form error.");
+  stat = ippsMontForm(BN(BigNumber::One()), pMont, BN(power));
+  ERROR_CHECK(stat == ippStsNoErr,
+              "FixedExpModExp: convert big number into Mont form error.");
+  storeEntry(power, table.data());
+  for (int e = 1; e < entries; e++) {
+    checkMontStatus(ippsMontMul(BN(power), BN(x), pMont, BN(power)));
+    storeEntry(power, table.data() + e * words);
+  }
+
+  // Fixed window: w squarings and one multiplication per digit, zero digits
+  // multiply by 1, so the schedule does not depend on the exponent value
+  std::vector<Ipp32u> sel(words);
+  BigNumber acc(m_mod), mul(m_mod);
+  selectEntry(table, words, entries, m_digits[0], sel.data());
+  acc.Set(sel.data(), words);
+  for (std::size_t k = 1; k < m_digits.size(); k++) {
+    for (int j = 0; j < m_window_bits; j++)
+      checkMontStatus(ippsMontMul(BN(acc), BN(acc), pMont, BN(acc)));
+    selectEntry(table, words, entries, m_digits[k], sel.data());
+    mul.Set(sel.data(), words);
+    checkMontStatus(ippsMontMul(BN(acc), BN(mul), pMont, BN(acc)));
+  }
+
+  // convert out of Montgomery form
+  BigNumber res(m_mod);
+  checkMontStatus(ippsMontMul(BN(acc), BN(BigNumber::One()), pMont, BN(res)));
+  return res;
+}
+
+std::vector<BigNumber> FixedExpModExp::exp(
+    const std::vector<BigNumber>& base) const {
+  std::size_t v_size = base.size();
+  std::vector<BigNumber> res(v_size);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < v_size; i++) res[i] = exp(base[i]);
+
+  return res;
+}
+
+}  // namespace ipcl
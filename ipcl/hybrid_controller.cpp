@@ -0,0 +1,85 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/hybrid_controller.hpp"
+
+#include <algorithm>
+
+namespace ipcl {
+
+HybridController::HybridController() { reset(); }
+
+HybridController& HybridController::getInstance() {
+  static HybridController controller;
+  return controller;
+}
+
+int HybridController::getBucket(std::size_t v_size) {
+  int bucket = 0;
+  while ((v_size >>= 1) > 0) bucket++;
+  return std::min(bucket, IPCL_HYBRID_ADAPTIVE_BUCKETS - 1);
+}
+
+// Start from the ratios of the OPTIMAL mode
+float HybridController::getInitialRatio(HybridOp op, int bucket) {
+  if ((std::size_t{1} << bucket) <= IPCL_WORKLOAD_SIZE_THRESHOLD)
+    return IPCL_HYBRID_MODEXP_RATIO_FULL;
+
+  switch (op) {
+    case HybridOp::ENCRYPT:
+      return IPCL_HYBRID_MODEXP_RATIO_ENCRYPT;
+    case HybridOp::DECRYPT:
+      return IPCL_HYBRID_MODEXP_RATIO_DECRYPT;
+    case HybridOp::MULTIPLY:
+      return IPCL_HYBRID_MODEXP_RATIO_MULTIPLY;
+    default:
+      return IPCL_HYBRID_MODEXP_RATIO_OTHER;
+  }
+}
+
+void HybridController::reset() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (int op = 0; op < m_stats.size(); op++)
+    for (int bucket = 0; bucket < IPCL_HYBRID_ADAPTIVE_BUCKETS; bucket++)
+      m_stats[op][bucket] = {
+          0.0, 0.0, getInitialRatio(static_cast<HybridOp>(op), bucket)};
+}
+
+float HybridController::getRatio(HybridOp op, std::size_t v_size) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats[static_cast<int>(op)][getBucket(v_size)].ratio;
+}
+
+std::size_t HybridController::getAcceleratorShare(HybridOp op,
+                                                  std::size_t v_size) const {
+  if (v_size < 2) return v_size;
+  auto share = static_cast<std::size_t>(getRatio(op, v_size) * v_size + 0.5);
+  return std::min(std::max<std::size_t>(share, 1), v_size - 1);
+}
+
+void HybridController::update(HybridOp op, std::size_t v_size,
+                              std::size_t accel_size, double accel_seconds,
+                              double cpu_seconds) {
+  std::size_t cpu_size = v_size - accel_size;
+  if (accel_size == 0 || cpu_size == 0 || accel_seconds <= 0.0 ||
+      cpu_seconds <= 0.0)
+    return;
+
+  double accel_rate = accel_size / accel_seconds;
+  double cpu_rate = cpu_size / cpu_seconds;
+  constexpr double alpha = IPCL_HYBRID_ADAPTIVE_ALPHA;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Stats& s = m_stats[static_cast<int>(op)][getBucket(v_size)];
+  s.accel_rate = (s.accel_rate > 0.0)
+                     ? alpha * accel_rate + (1.0 - alpha) * s.accel_rate
+                     : accel_rate;
+  s.cpu_rate = (s.cpu_rate > 0.0)
+                   ? alpha * cpu_rate + (1.0 - alpha) * s.cpu_rate
+                   : cpu_rate;
+
+  // Equal completion times: accel_size / accel_rate == cpu_size / cpu_rate
+  s.ratio = static_cast<float>(s.accel_rate / (s.accel_rate + s.cpu_rate));
+}
+
+}  // namespace ipcl
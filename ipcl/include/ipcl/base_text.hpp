@@ -24,6 +24,12 @@ class BaseText {
   explicit BaseText(const BigNumber& bn);
   explicit BaseText(const std::vector<BigNumber>& bn_v);
 
+  /**
+   * BaseText constructors taking ownership of the BigNumber elements
+   */
+  explicit BaseText(BigNumber&& bn);
+  explicit BaseText(std::vector<BigNumber>&& bn_v);
+
   /**
    * BaseText copy constructor
    */
@@ -34,6 +40,16 @@ class BaseText {
    */
   BaseText& operator=(const BaseText& other);
 
+  /**
+   * BaseText move constructor
+   */
+  BaseText(BaseText&& bt) noexcept;
+
+  /**
+   * BaseText move assignment
+   */
+  BaseText& operator=(BaseText&& other) noexcept;
+
   /**
    * Overloading [] operator to access BigNumber elements
    */
@@ -61,9 +77,11 @@ class BaseText {
   /**
    * Gets the specified BigNumber element in m_text
    * @param[in] idx Element index
-   * return Element in m_text of type BigNumber
+   * return Reference to the element in m_text, or the element itself when
+   * called on an rvalue
    */
-  BigNumber getElement(const std::size_t& idx) const;
+  const BigNumber& getElement(const std::size_t& idx) const&;
+  BigNumber getElement(const std::size_t& idx) &&;
 
   /**
    * Gets the specified BigNumber vector form
@@ -90,8 +108,11 @@ class BaseText {
 
   /**
    * Gets the BigNumber container
+   * return Reference to the container without copying it, or the container
+   * itself when called on an rvalue
    */
-  std::vector<BigNumber> getTexts() const;
+  const std::vector<BigNumber>& getTexts() const&;
+  std::vector<BigNumber> getTexts() &&;
 
   /**
    * Gets the size of the BigNumber container
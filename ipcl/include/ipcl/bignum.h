@@ -33,6 +33,8 @@ class BigNumber : public ipcl::serializer::serializerBase {
   BigNumber(const Ipp32u* pData, int length = 1,
             IppsBigNumSGN sgn = IppsBigNumPOS);
   BigNumber(const BigNumber& bn);
+  // the moved-from object holds no state and reads as zero
+  BigNumber(BigNumber&& bn) noexcept;
   BigNumber(const char* s);
   virtual ~BigNumber();
   const void* addr = static_cast<const void*>(this);
@@ -41,8 +43,8 @@ class BigNumber : public ipcl::serializer::serializerBase {
   void Set(const Ipp32u* pData, int length = 1,
            IppsBigNumSGN sgn = IppsBigNumPOS);
   // conversion to IppsBigNumState
-  friend IppsBigNumState* BN(const BigNumber& bn) { return bn.m_pBN; }
-  operator IppsBigNumState*() const { return m_pBN; }
+  friend IppsBigNumState* BN(const BigNumber& bn) { return bn.state(); }
+  operator IppsBigNumState*() const { return state(); }
 
   // some useful constants
   static const BigNumber& Zero();
@@ -51,6 +53,7 @@ class BigNumber : public ipcl::serializer::serializerBase {
 
   // arithmetic operators probably need
   BigNumber& operator=(const BigNumber& bn);
+  BigNumber& operator=(BigNumber&& bn) noexcept;
   // Bin: Support integer add
   BigNumber& operator+=(Ipp32u n);
   BigNumber& operator+=(const BigNumber& bn);
@@ -146,7 +149,7 @@ class BigNumber : public ipcl::serializer::serializerBase {
     IppsBigNumSGN sign;
     ar(cereal::make_nvp("BigNumber", vec));
     ar(cereal::make_nvp("Sign", sign));
-    create(vec.data(), vec.size(), sign);
+    *this = BigNumber(vec.data(), vec.size(), sign);
   }
 
   std::string serializedName() const { return "BigNumber"; }
@@ -154,6 +157,11 @@ class BigNumber : public ipcl::serializer::serializerBase {
 
   bool create(const Ipp32u* pData, int length,
               IppsBigNumSGN sgn = IppsBigNumPOS);
+  // the state, created as zero when the number has been moved from
+  IppsBigNumState* state() const {
+    if (!m_pBN) const_cast<BigNumber*>(this)->create(nullptr, 1);
+    return m_pBN;
+  }
   IppsBigNumState* m_pBN;
 };
 
@@ -4,6 +4,7 @@
 #ifndef IPCL_INCLUDE_IPCL_CIPHERTEXT_HPP_
 #define IPCL_INCLUDE_IPCL_CIPHERTEXT_HPP_
 
+#include <future>  // NOLINT [build/c++11]
 #include <memory>
 #include <vector>
 
@@ -26,6 +27,12 @@ class CipherText : public BaseText {
   CipherText(const PublicKey& pk, const BigNumber& bn);
   CipherText(const PublicKey& pk, const std::vector<BigNumber>& bn_vec);
 
+  /**
+   * CipherText constructors taking ownership of the BigNumber elements
+   */
+  CipherText(const PublicKey& pk, BigNumber&& bn);
+  CipherText(const PublicKey& pk, std::vector<BigNumber>&& bn_vec);
+
   /**
    * CipherText copy constructor
    */
@@ -35,6 +42,15 @@ class CipherText : public BaseText {
    */
   CipherText& operator=(const CipherText& other);
 
+  /**
+   * CipherText move constructor
+   */
+  CipherText(CipherText&& ct) noexcept;
+  /**
+   * CipherText move assignment
+   */
+  CipherText& operator=(CipherText&& other) noexcept;
+
   // CT+CT
   CipherText operator+(const CipherText& other) const;
   // CT+PT
@@ -42,15 +58,22 @@ class CipherText : public BaseText {
   // CT*PT
   CipherText operator*(const PlainText& other) const;
 
+  /**
+   * CT*PT computed asynchronously on the default executor
+   * @param[in] other PlainText multiplier
+   * @return future of the product
+   */
+  std::future<CipherText> multiplyAsync(const PlainText& other) const;
+
   /**
    * Get ciphertext of idx
    */
   CipherText getCipherText(const size_t& idx) const;
 
   /**
-   * Get public key
+   * Get the shared handle of the public key
    */
-  std::shared_ptr<PublicKey> getPubKey() const;
+  std::shared_ptr<const PublicKey> getPubKey() const;
 
   /**
    * Rotate CipherText
@@ -58,14 +81,65 @@ class CipherText : public BaseText {
    */
   CipherText rotate(int shift) const;
 
+  /**
+   * Homomorphic sum of all the elements
+   * @return the CipherText of size 1 of the sum
+   */
+  CipherText sum() const;
+
+  /**
+   * Homomorphic sums of contiguous blocks of elements
+   * @param[in] block_size number of elements per block, the last block holds
+   * the remaining elements
+   * @return the CipherText of the block sums
+   */
+  CipherText sum(std::size_t block_size) const;
+
+  /**
+   * Convert into the Montgomery domain of n^2.
+   * In this domain CT+CT and sum() run Montgomery multiplications instead
+   * of full multiplications and divisions mod n^2, so chained operations
+   * stay in the domain and only convert back once. CT*PT converts out and
+   * back around the exponentiation. decrypt() accepts either domain,
+   * getTexts() and getElement() return the Montgomery form.
+   * @return the CipherText in Montgomery form
+   */
+  CipherText toMontgomery() const;
+
+  /**
+   * Convert out of the Montgomery domain of n^2
+   * @return the CipherText in standard form
+   */
+  CipherText fromMontgomery() const;
+
+  /**
+   * Whether the elements are in the Montgomery domain of n^2
+   */
+  bool isMontgomery() const { return m_mont; }
+
  private:
   BigNumber raw_add(const BigNumber& a, const BigNumber& b) const;
   BigNumber raw_mul(const BigNumber& a, const BigNumber& b) const;
   std::vector<BigNumber> raw_mul(const std::vector<BigNumber>& a,
                                  const std::vector<BigNumber>& b) const;
+  std::vector<BigNumber> raw_mul(const std::vector<BigNumber>& a,
+                                 const BigNumber& b) const;
+
+  CipherText(std::shared_ptr<const PublicKey> pk,
+             std::vector<BigNumber>&& bn_v, bool mont = false);
 
-  std::shared_ptr<PublicKey> m_pk;  ///< Public key used to encrypt big number
+  std::shared_ptr<const PublicKey> m_pk;  ///< Handle of the public key
+  bool m_mont = false;  ///< Elements are in the Montgomery domain of n^2
 };
 
+/**
+ * Homomorphic inner product, encrypts the sum of ct[i] * pt[i] as one
+ * multi-exponentiation prod(ct[i]^pt[i]) mod n^2
+ * @param[in] ct encrypted vector
+ * @param[in] pt plaintext weights of the same size as ct
+ * @return the CipherText of size 1 of the inner product
+ */
+CipherText innerProduct(const CipherText& ct, const PlainText& pt);
+
 }  // namespace ipcl
 #endif  // IPCL_INCLUDE_IPCL_CIPHERTEXT_HPP_
@@ -0,0 +1,89 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_ENCODER_HPP_
+#define IPCL_INCLUDE_IPCL_ENCODER_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "ipcl/plaintext.hpp"
+#include "ipcl/pub_key.hpp"
+
+namespace ipcl {
+
+/**
+ * Signed and fixed-point encoder packing several values into every
+ * plaintext element.
+ * A value x is scaled to round(x * 2^frac_bits) and stored as a signed
+ * digit of slot_bits = value_bits + headroom_bits bits, the element being
+ * sum(x_i * 2^(slot_bits * i)) mod n. Homomorphic additions and products by
+ * small integer scalars act on every slot at once, and the headroom bits
+ * absorb their growth: decoding is exact as long as every slot stays within
+ * [-2^(slot_bits - 1), 2^(slot_bits - 1)).
+ */
+class Encoder {
+ public:
+  /**
+   * Encoder constructor
+   * @param[in] pk public key whose n bounds the slots per element
+   * @param[in] value_bits bit length of a signed value after scaling
+   * @param[in] headroom_bits overflow bits reserved per slot
+   * @param[in] frac_bits fractional bits of the fixed-point values
+   */
+  explicit Encoder(const PublicKey& pk, int value_bits = 32,
+                   int headroom_bits = 16, int frac_bits = 0);
+
+  /**
+   * Encode signed integers
+   * @param[in] v values within [-2^(value_bits - 1), 2^(value_bits - 1))
+   * @return PlainText of ceil(v.size() / getSlotsPerElement()) elements
+   */
+  PlainText encode(const std::vector<int64_t>& v) const;
+
+  /**
+   * Encode fixed-point values
+   * @param[in] v values, scaled by 2^frac_bits and rounded
+   * @return PlainText of ceil(v.size() / getSlotsPerElement()) elements
+   */
+  PlainText encode(const std::vector<double>& v) const;
+
+  /**
+   * Decode signed integers
+   * @param[in] pt decrypted PlainText
+   * @param[in] count number of encoded values
+   */
+  std::vector<int64_t> decodeInt(const PlainText& pt, std::size_t count) const;
+
+  /**
+   * Decode fixed-point values
+   * @param[in] pt decrypted PlainText
+   * @param[in] count number of encoded values
+   */
+  std::vector<double> decodeDouble(const PlainText& pt,
+                                   std::size_t count) const;
+
+  /**
+   * Get the number of values packed into a plaintext element
+   */
+  int getSlotsPerElement() const { return m_slots; }
+
+  /**
+   * Get the bit length of a slot
+   */
+  int getSlotBits() const { return m_slot_bits; }
+
+ private:
+  BigNumber pack(const int64_t* v, std::size_t count) const;
+  void unpack(const BigNumber& bn, int64_t* v, std::size_t count) const;
+
+  BigNumber m_n;
+  BigNumber m_half_n;  ///< values above n/2 encode negative numbers
+  int m_value_bits;
+  int m_slot_bits;
+  int m_frac_bits;
+  int m_slots;
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_ENCODER_HPP_
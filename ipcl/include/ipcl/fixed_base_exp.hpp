@@ -0,0 +1,70 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_FIXED_BASE_EXP_HPP_
+#define IPCL_INCLUDE_IPCL_FIXED_BASE_EXP_HPP_
+
+#include <vector>
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Fixed-base modular exponentiation engine.
+ * Precomputes base^(2^(w*i)) mod m once (windowed bucket method), so that
+ * each base^e mod m costs (max_exp_bits / w + 2^(w+1)) Montgomery
+ * multiplications instead of a full exponentiation. Neither the
+ * multiplications nor the memory accesses depend on the value of e, as e
+ * may be secret.
+ */
+class FixedBaseModExp {
+ public:
+  FixedBaseModExp() = delete;
+  ~FixedBaseModExp() = default;
+
+  /**
+   * FixedBaseModExp constructor
+   * @param[in] base fixed base of the exponentiation
+   * @param[in] mod odd modulus
+   * @param[in] max_exp_bits maximum bit length of exponents served by the
+   * table, larger exponents fall back to modExp
+   */
+  FixedBaseModExp(const BigNumber& base, const BigNumber& mod,
+                  int max_exp_bits);
+
+  /**
+   * Compute base^pow mod m
+   * @param[in] pow pow of the exponentiation
+   * @return the modular exponentiation result of type BigNumber
+   */
+  BigNumber exp(const BigNumber& pow) const;
+
+  /**
+   * Compute base^pow mod m for multi BigNumber
+   * @param[in] pow pows of the exponentiation
+   * @return the modular exponentiation results of type BigNumber
+   */
+  std::vector<BigNumber> exp(const std::vector<BigNumber>& pow) const;
+
+  /**
+   * Get the window size in bits used by the table
+   */
+  int getWindowBits() const { return m_window_bits; }
+
+  /**
+   * Get the maximum exponent bit length served by the table
+   */
+  int getMaxExpBits() const { return m_max_exp_bits; }
+
+ private:
+  int m_window_bits;
+  int m_max_exp_bits;
+  BigNumber m_base;
+  BigNumber m_mod;
+  BigNumber m_mont_one;             ///< 1 in Montgomery form
+  std::vector<BigNumber> m_powers;  ///< base^(2^(w*i)) in Montgomery form
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_FIXED_BASE_EXP_HPP_
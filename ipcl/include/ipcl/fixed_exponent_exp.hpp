@@ -0,0 +1,59 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_FIXED_EXPONENT_EXP_HPP_
+#define IPCL_INCLUDE_IPCL_FIXED_EXPONENT_EXP_HPP_
+
+#include <vector>
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Fixed-exponent modular exponentiation engine.
+ * Recodes the exponent once into fixed windows and replays them for every
+ * base, so batches raised to the same exponent (decryption, normal
+ * obfuscators) share the recoding work. Every window costs the same
+ * squarings and one multiplication with a table entry read in constant time,
+ * as the exponent may be secret (lambda, p - 1, q - 1).
+ */
+class FixedExpModExp {
+ public:
+  FixedExpModExp() = delete;
+  ~FixedExpModExp() = default;
+
+  /**
+   * FixedExpModExp constructor
+   * @param[in] exp non-negative fixed pow of the exponentiation
+   * @param[in] mod odd modulus
+   */
+  FixedExpModExp(const BigNumber& exp, const BigNumber& mod);
+
+  /**
+   * Compute base^exp mod m
+   * @param[in] base base of the exponentiation, less than the modulus
+   * @return the modular exponentiation result of type BigNumber
+   */
+  BigNumber exp(const BigNumber& base) const;
+
+  /**
+   * Compute base^exp mod m for multi BigNumber
+   * @param[in] base bases of the exponentiation, less than the modulus
+   * @return the modular exponentiation results of type BigNumber
+   */
+  std::vector<BigNumber> exp(const std::vector<BigNumber>& base) const;
+
+  /**
+   * Get the window size in bits of the recoded exponent
+   */
+  int getWindowBits() const { return m_window_bits; }
+
+ private:
+  int m_window_bits;
+  BigNumber m_mod;
+  std::vector<int> m_digits;  ///< window digits, most significant first
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_FIXED_EXPONENT_EXP_HPP_
@@ -0,0 +1,82 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_HYBRID_CONTROLLER_HPP_
+#define IPCL_INCLUDE_IPCL_HYBRID_CONTROLLER_HPP_
+
+#include <array>
+#include <mutex>
+
+#include "ipcl/mod_exp.hpp"
+#include "ipcl/utils/common.hpp"
+
+namespace ipcl {
+
+/**
+ * Online controller of the ADAPTIVE hybrid mode.
+ * Keeps an exponentially weighted estimate of the accelerator and CPU
+ * throughput per operation type and batch size class (power of 2), and
+ * splits each batch so that both backends are expected to finish together:
+ * ratio = accel_rate / (accel_rate + cpu_rate).
+ */
+class HybridController {
+ public:
+  HybridController(const HybridController&) = delete;
+  HybridController& operator=(const HybridController&) = delete;
+
+  /**
+   * Get the controller shared by all threads
+   */
+  static HybridController& getInstance();
+
+  /**
+   * Get the current accelerator ratio
+   * @param[in] op operation type of the batch
+   * @param[in] v_size batch size
+   */
+  float getRatio(HybridOp op, std::size_t v_size) const;
+
+  /**
+   * Get the number of elements of a batch to offload to the accelerator,
+   * both backends get at least one element so that they stay measured
+   * @param[in] op operation type of the batch
+   * @param[in] v_size batch size
+   */
+  std::size_t getAcceleratorShare(HybridOp op, std::size_t v_size) const;
+
+  /**
+   * Feed back the measured completion times of a split batch
+   * @param[in] op operation type of the batch
+   * @param[in] v_size batch size
+   * @param[in] accel_size number of elements run on the accelerator
+   * @param[in] accel_seconds completion time of the accelerator share
+   * @param[in] cpu_seconds completion time of the CPU share
+   */
+  void update(HybridOp op, std::size_t v_size, std::size_t accel_size,
+              double accel_seconds, double cpu_seconds);
+
+  /**
+   * Forget all measurements and restart from the OPTIMAL ratios
+   */
+  void reset();
+
+ private:
+  HybridController();
+
+  struct Stats {
+    double accel_rate;  ///< elements per second, 0 until measured
+    double cpu_rate;    ///< elements per second, 0 until measured
+    float ratio;
+  };
+
+  static int getBucket(std::size_t v_size);
+  static float getInitialRatio(HybridOp op, int bucket);
+
+  mutable std::mutex m_mutex;
+  std::array<std::array<Stats, IPCL_HYBRID_ADAPTIVE_BUCKETS>,
+             static_cast<int>(HybridOp::OTHER) + 1>
+      m_stats;
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_HYBRID_CONTROLLER_HPP_
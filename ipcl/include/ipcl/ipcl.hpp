@@ -4,7 +4,11 @@
 #ifndef IPCL_INCLUDE_IPCL_IPCL_HPP_
 #define IPCL_INCLUDE_IPCL_IPCL_HPP_
 
+#include "ipcl/encoder.hpp"
+#include "ipcl/fixed_exponent_exp.hpp"
+#include "ipcl/hybrid_controller.hpp"
 #include "ipcl/mod_exp.hpp"
+#include "ipcl/mod_mul.hpp"
 #include "ipcl/pri_key.hpp"
 #include "ipcl/utils/context.hpp"
 #include "ipcl/utils/serialize.hpp"
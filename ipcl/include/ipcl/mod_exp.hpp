@@ -4,9 +4,13 @@
 #ifndef IPCL_INCLUDE_IPCL_MOD_EXP_HPP_
 #define IPCL_INCLUDE_IPCL_MOD_EXP_HPP_
 
+#include <chrono>  // NOLINT [build/c++11]
+#include <functional>
+#include <future>  // NOLINT [build/c++11]
 #include <vector>
 
 #include "ipcl/bignum.h"
+#include "ipcl/packed_bignum.hpp"
 
 namespace ipcl {
 
@@ -26,9 +30,47 @@ enum class HybridMode {
   PREF_IPP80 = 20,
   PREF_IPP90 = 10,
   IPP = 0,
-  UNDEFINED = -1
+  UNDEFINED = -1,
+  ADAPTIVE = -2  ///< ratio tuned online by the HybridController
 };
 
+/**
+ * Operation type of modExp batches, the ADAPTIVE mode tunes one ratio per
+ * operation type
+ */
+enum class HybridOp { ENCRYPT = 0, DECRYPT, MULTIPLY, OTHER };
+
+/**
+ * Hybrid settings of a thread
+ */
+struct HybridParams {
+  float ratio;
+  HybridMode mode;
+  HybridOp op = HybridOp::OTHER;
+};
+
+/**
+ * Tag the modExp batches issued by the calling thread within the scope with
+ * an operation type
+ */
+class HybridOpScope {
+ public:
+  explicit HybridOpScope(HybridOp op);
+  ~HybridOpScope();
+  HybridOpScope(const HybridOpScope&) = delete;
+  HybridOpScope& operator=(const HybridOpScope&) = delete;
+
+ private:
+  HybridOp m_prev;
+};
+
+/**
+ * Accelerator backend of hybrid modExp, computes base[i]^exp[i] mod mod[i]
+ */
+using HybridAccelerator = std::function<std::vector<BigNumber>(
+    const std::vector<BigNumber>& base, const std::vector<BigNumber>& exp,
+    const std::vector<BigNumber>& mod)>;
+
 /**
  * Set hybrid mode
  * @param[in] mode The type of hybrid mode
@@ -62,6 +104,46 @@ HybridMode getHybridMode();
  */
 bool isHybridOptimal();
 
+/**
+ * Check current hybrid mode is ADAPTIVE
+ */
+bool isHybridAdaptive();
+
+/**
+ * Install the accelerator backend of hybrid modExp for all threads
+ * @param[in] accel accelerator backend, nullptr restores the default (QAT
+ * when built with IPCL_ENABLE_QAT, none otherwise)
+ */
+void setHybridAccelerator(HybridAccelerator accel);
+
+/**
+ * Check whether hybrid modExp has an accelerator backend
+ */
+bool hasHybridAccelerator();
+
+/**
+ * Software stand-in for an accelerator, computes on the calling thread and
+ * completes each request no earlier than the modeled device latency
+ * @param[in] batch_latency fixed latency of a request
+ * @param[in] element_latency additional latency per element
+ * @return accelerator backend to be installed with setHybridAccelerator
+ */
+HybridAccelerator makeEmulatedAccelerator(
+    std::chrono::microseconds batch_latency,
+    std::chrono::microseconds element_latency);
+
+/**
+ * Get the hybrid settings of the calling thread
+ */
+HybridParams getHybridParams();
+
+/**
+ * Set the hybrid settings of the calling thread, used to carry the settings
+ * of a caller over to the thread running its work
+ * @param[in] params hybrid ratio and mode
+ */
+void setHybridParams(const HybridParams& params);
+
 /**
  * Modular exponentiation for multi BigNumber
  * @param[in] base base of the exponentiation
@@ -72,6 +154,83 @@ bool isHybridOptimal();
 std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
                               const std::vector<BigNumber>& exp,
                               const std::vector<BigNumber>& mod);
+
+/**
+ * Modular exponentiation for multi BigNumber sharing one modulus
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow of the exponentiation
+ * @param[in] mod modular shared by all the bases
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
+                              const std::vector<BigNumber>& exp,
+                              const BigNumber& mod);
+
+/**
+ * Modular exponentiation for multi BigNumber sharing one pow and modulus
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow shared by all the bases
+ * @param[in] mod modular shared by all the bases
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
+                              const BigNumber& exp, const BigNumber& mod);
+
+/**
+ * Modular exponentiation of the two halves of a CRT computation,
+ * res_p[i] = base_p[i]^exp_p mod mod_p and res_q[i] = base_q[i]^exp_q mod
+ * mod_q. The halves share the lanes of the multi-buffer kernel when it is
+ * used, and run as two batches with a shared pow and modulus otherwise.
+ * @param[out] res_p results of the first half
+ * @param[out] res_q results of the second half
+ * @param[in] base_p bases of the first half
+ * @param[in] exp_p pow shared by the first half
+ * @param[in] mod_p modular shared by the first half
+ * @param[in] base_q bases of the second half
+ * @param[in] exp_q pow shared by the second half
+ * @param[in] mod_q modular shared by the second half
+ */
+void modExpCRT(std::vector<BigNumber>& res_p, std::vector<BigNumber>& res_q,
+               const std::vector<BigNumber>& base_p, const BigNumber& exp_p,
+               const BigNumber& mod_p, const std::vector<BigNumber>& base_q,
+               const BigNumber& exp_q, const BigNumber& mod_q);
+
+/**
+ * Modular exponentiation for packed big numbers sharing one modulus, the
+ * multi-buffer kernel reads the operands and writes the results in place
+ * @param[in] base packed bases, with a stride fitting the modulus
+ * @param[in] exp packed pows, of the size of base or of size 1 for a pow
+ * shared by all the bases, no wider than the modulus
+ * @param[in] mod modular shared by all the bases
+ * @return the packed modular exponentiation results, with the bit length of
+ * the modulus
+ */
+PackedBigNumbers modExp(const PackedBigNumbers& base,
+                        const PackedBigNumbers& exp, const BigNumber& mod);
+
+/**
+ * Modular exponentiation for packed big numbers sharing one pow and modulus
+ * @param[in] base packed bases, with a stride fitting the modulus
+ * @param[in] exp pow shared by all the bases
+ * @param[in] mod modular shared by all the bases
+ * @return the packed modular exponentiation results, with the bit length of
+ * the modulus
+ */
+PackedBigNumbers modExp(const PackedBigNumbers& base, const BigNumber& exp,
+                        const BigNumber& mod);
+
+/**
+ * Asynchronous modular exponentiation for multi BigNumber, run on the
+ * default executor with the hybrid settings of the caller
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow of the exponentiation
+ * @param[in] mod modular
+ * @return future of the modular exponentiation result
+ */
+std::future<std::vector<BigNumber>> modExpAsync(std::vector<BigNumber> base,
+                                                std::vector<BigNumber> exp,
+                                                std::vector<BigNumber> mod);
+
 /**
  * Modular exponentiation for single BigNumber
  * @param[in] base base of the exponentiation
@@ -93,6 +252,27 @@ std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
                                  const std::vector<BigNumber>& exp,
                                  const std::vector<BigNumber>& mod);
 
+/**
+ * IPP modular exponentiation for multi buffer sharing one modulus
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow of the exponentiation
+ * @param[in] mod modular shared by all the bases
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
+                                 const std::vector<BigNumber>& exp,
+                                 const BigNumber& mod);
+
+/**
+ * IPP modular exponentiation for multi buffer sharing one pow and modulus
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow shared by all the bases
+ * @param[in] mod modular shared by all the bases
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
+                                 const BigNumber& exp, const BigNumber& mod);
+
 /**
  * IPP modular exponentiation for single buffer
  * @param[in] base base of the exponentiation
@@ -0,0 +1,30 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_MOD_MUL_HPP_
+#define IPCL_INCLUDE_IPCL_MOD_MUL_HPP_
+
+#include <vector>
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Batched modular multiplication, computes res[i] = a[i] * b[i] mod m.
+ * With AVX512-IFMA, eight multiplications run in the lanes of one 8-way
+ * Montgomery multiplication in radix 2^52, and first operands up to m^2
+ * are reduced by a Montgomery reduction in the same lanes instead of a
+ * division. Otherwise every multiplication is a full multiplication
+ * followed by a division.
+ * @param[in] a first operands
+ * @param[in] b second operands, of the same size as a or of size 1
+ * @param[in] mod odd modulus
+ * @return the modular products
+ */
+std::vector<BigNumber> modMul(const std::vector<BigNumber>& a,
+                              const std::vector<BigNumber>& b,
+                              const BigNumber& mod);
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_MOD_MUL_HPP_
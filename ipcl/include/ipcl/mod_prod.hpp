@@ -0,0 +1,33 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_MOD_PROD_HPP_
+#define IPCL_INCLUDE_IPCL_MOD_PROD_HPP_
+
+#include <vector>
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Modular product reduction over contiguous blocks, computes
+ * res[j] = prod(v[j * block_size + i]) mod m. The blocks are split into
+ * parts multiplied on separate threads, one Montgomery multiplication per
+ * element without converting the elements into Montgomery form, and the
+ * partial products of a block are combined as a parallel binary tree. The
+ * accumulated R^-1 factors are removed with one multiplication per block,
+ * or cancel out when the elements are in Montgomery form.
+ * @param[in] v elements less than the modulus
+ * @param[in] block_size number of elements per block, the last block holds
+ * the remaining elements
+ * @param[in] mod odd modulus
+ * @param[in] mont_form elements and products are in Montgomery form
+ * @return the product of each block
+ */
+std::vector<BigNumber> modProd(const std::vector<BigNumber>& v,
+                               std::size_t block_size, const BigNumber& mod,
+                               bool mont_form = false);
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_MOD_PROD_HPP_
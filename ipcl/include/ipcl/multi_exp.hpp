@@ -0,0 +1,29 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_MULTI_EXP_HPP_
+#define IPCL_INCLUDE_IPCL_MULTI_EXP_HPP_
+
+#include <vector>
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Simultaneous multi-exponentiation, computes prod(base[i]^exp[i]) mod m
+ * with Pippenger's bucket method: the exponents are cut into w-bit windows
+ * and, per window, every base is multiplied into the bucket of its digit
+ * once, so the cost is about (exp_bits / w) * (n + 2^(w+1)) Montgomery
+ * multiplications instead of n full exponentiations. The bases are split
+ * into contiguous parts computed on separate threads.
+ * @param[in] base bases of the exponentiation, less than the modulus
+ * @param[in] exp non-negative pows of the exponentiation
+ * @param[in] mod odd modulus
+ * @return the product of the modular exponentiations
+ */
+BigNumber multiExp(const std::vector<BigNumber>& base,
+                   const std::vector<BigNumber>& exp, const BigNumber& mod);
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_MULTI_EXP_HPP_
@@ -0,0 +1,111 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_OBFUSCATOR_POOL_HPP_
+#define IPCL_INCLUDE_IPCL_OBFUSCATOR_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>  // NOLINT [build/c++11]
+#include <vector>
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Pool of precomputed obfuscators.
+ * Background threads fill a bounded lock-free ring buffer with obfuscators
+ * produced by the generator and refill it whenever the number of available
+ * obfuscators drops below the low-water mark. Each obfuscator is handed out
+ * exactly once.
+ */
+class ObfuscatorPool {
+ public:
+  using Generator = std::function<std::vector<BigNumber>(std::size_t)>;
+
+  ObfuscatorPool() = delete;
+  ObfuscatorPool(const ObfuscatorPool&) = delete;
+  ObfuscatorPool& operator=(const ObfuscatorPool&) = delete;
+
+  /**
+   * ObfuscatorPool constructor
+   * @param[in] generator function producing a given number of obfuscators
+   * @param[in] capacity maximum number of stored obfuscators (rounded up to a
+   * power of 2)
+   * @param[in] low_water_mark refill is triggered below this number
+   * @param[in] num_threads number of background refill threads
+   */
+  ObfuscatorPool(Generator generator, std::size_t capacity,
+                 std::size_t low_water_mark, int num_threads = 1);
+
+  /**
+   * ObfuscatorPool destructor, stops and joins the refill threads
+   */
+  ~ObfuscatorPool();
+
+  /**
+   * Take up to sz obfuscators out of the pool without blocking
+   * @param[in] sz number of requested obfuscators
+   * @return obfuscators taken from the pool, may be fewer than sz
+   * @throw the exception that stopped the refill threads, once the generator
+   * has failed
+   */
+  std::vector<BigNumber> acquire(std::size_t sz);
+
+  /**
+   * Get the number of obfuscators currently available
+   */
+  std::size_t getAvailable() const;
+
+  /**
+   * Get the capacity of the pool
+   */
+  std::size_t getCapacity() const { return m_capacity; }
+
+  /**
+   * Get the low-water mark of the pool
+   */
+  std::size_t getLowWaterMark() const { return m_low_water_mark; }
+
+  /**
+   * Get the number of refill threads
+   */
+  int getThreadCount() const { return static_cast<int>(m_threads.size()); }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> seq;
+    BigNumber value;
+  };
+
+  bool push(BigNumber&& bn);
+  bool pop(BigNumber& bn);
+  std::size_t getPending() const;
+  std::size_t reserve();
+  void refill();
+
+  Generator m_generator;
+  std::size_t m_capacity;
+  std::size_t m_low_water_mark;
+  std::size_t m_mask;
+  std::unique_ptr<Cell[]> m_cells;
+
+  alignas(64) std::atomic<std::size_t> m_enqueue_pos;
+  alignas(64) std::atomic<std::size_t> m_dequeue_pos;
+  alignas(64) std::atomic<std::size_t> m_in_flight;  ///< reserved by refills
+
+  std::atomic<bool> m_stop;
+  std::atomic<bool> m_failed;
+  std::exception_ptr m_error;  ///< first generator failure, guarded by m_mutex
+  std::mutex m_mutex;
+  std::condition_variable m_refill_cv;
+  std::vector<std::thread> m_threads;
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_OBFUSCATOR_POOL_HPP_
@@ -0,0 +1,123 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_PACKED_BIGNUM_HPP_
+#define IPCL_INCLUDE_IPCL_PACKED_BIGNUM_HPP_
+
+#include <new>
+#include <vector>
+
+#include "ipcl/bignum.h"
+#include "ipcl/utils/common.hpp"
+
+namespace ipcl {
+
+/**
+ * Allocator of cache line aligned buffers
+ */
+template <typename T>
+struct AlignedAllocator {
+  using value_type = T;
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U>&) {}  // NOLINT
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(::operator new(
+        n * sizeof(T), std::align_val_t(IPCL_PACKED_BIGNUM_ALIGNMENT)));
+  }
+  void deallocate(T* p, std::size_t) {
+    ::operator delete(p, std::align_val_t(IPCL_PACKED_BIGNUM_ALIGNMENT));
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U>&) const {
+    return false;
+  }
+};
+
+/**
+ * Packed storage of non-negative big numbers.
+ * All the elements live in one aligned buffer of 64-bit little-endian limbs,
+ * at a fixed stride rounded up to whole cache lines, so the batched modExp
+ * engine hands the elements to the multi-buffer kernel in place instead of
+ * gathering them from separately allocated IppsBigNumState. It is an operand
+ * format of modExp only, the text classes keep their elements as BigNumber.
+ * The rows are not lane-interleaved, mbx_exp_mb8 takes one pointer per lane.
+ */
+class PackedBigNumbers {
+ public:
+  PackedBigNumbers() = default;
+  ~PackedBigNumbers() = default;
+
+  /**
+   * PackedBigNumbers constructor, all elements are set to zero
+   * @param[in] size number of elements
+   * @param[in] bits maximum bit length of an element
+   */
+  PackedBigNumbers(std::size_t size, int bits);
+
+  /**
+   * PackedBigNumbers constructor packing a BigNumber vector
+   * @param[in] bn_v non-negative big numbers to be packed
+   * @param[in] bits maximum bit length of an element (0 for the longest
+   * element of bn_v)
+   */
+  explicit PackedBigNumbers(const std::vector<BigNumber>& bn_v, int bits = 0);
+
+  /**
+   * Unpack all the elements
+   */
+  std::vector<BigNumber> unpack() const;
+
+  /**
+   * Gets the specified element
+   * @param[in] idx element index
+   */
+  BigNumber get(std::size_t idx) const;
+
+  /**
+   * Sets the specified element
+   * @param[in] idx element index
+   * @param[in] bn non-negative big number fitting in the element bit length
+   */
+  void set(std::size_t idx, const BigNumber& bn);
+
+  /**
+   * Gets the limbs of the specified element
+   * @param[in] idx element index
+   */
+  Ipp64u* data(std::size_t idx) { return m_limbs.data() + idx * m_stride; }
+  const Ipp64u* data(std::size_t idx) const {
+    return m_limbs.data() + idx * m_stride;
+  }
+
+  /**
+   * Gets the number of elements
+   */
+  std::size_t size() const { return m_size; }
+
+  /**
+   * Gets the maximum bit length of an element
+   */
+  int getBits() const { return m_bits; }
+
+  /**
+   * Gets the distance in limbs between two consecutive elements
+   */
+  std::size_t getStride() const { return m_stride; }
+
+ private:
+  std::size_t m_size = 0;
+  int m_bits = 0;
+  std::size_t m_stride = 0;
+  std::vector<Ipp64u, AlignedAllocator<Ipp64u>> m_limbs;
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_PACKED_BIGNUM_HPP_
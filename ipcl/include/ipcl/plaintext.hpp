@@ -44,6 +44,18 @@ class PlainText : public BaseText {
    */
   explicit PlainText(const std::vector<BigNumber>& bn_v);
 
+  /**
+   * PlainText constructor taking ownership of a BigNumber
+   * @param[in] bn Rvalue reference to a BigNumber
+   */
+  explicit PlainText(BigNumber&& bn);
+
+  /**
+   * PlainText constructor taking ownership of a BigNumber vector
+   * @param[in] bn_v Rvalue reference to a BigNumber vector
+   */
+  explicit PlainText(std::vector<BigNumber>&& bn_v);
+
   /**
    * PlainText copy constructor
    */
@@ -54,6 +66,16 @@ class PlainText : public BaseText {
    */
   PlainText& operator=(const PlainText& other);
 
+  /**
+   * PlainText move constructor
+   */
+  PlainText(PlainText&& pt) noexcept;
+
+  /**
+   * PlainText move assignment
+   */
+  PlainText& operator=(PlainText&& other) noexcept;
+
   /**
    * User define implicit type conversion
    * Convert 1st element to uint32_t vector.
@@ -64,13 +86,15 @@ class PlainText : public BaseText {
    * User define implicit type conversion
    * Convert 1st element to type BigNumber.
    */
-  operator BigNumber() const;
+  operator BigNumber() const&;
+  operator BigNumber() &&;
 
   /**
    * User define implicit type conversion
    * Convert all element to type BigNumber.
    */
-  operator std::vector<BigNumber>() const;
+  operator std::vector<BigNumber>() const&;
+  operator std::vector<BigNumber>() &&;
 
   /**
    * PT + CT
@@ -4,6 +4,7 @@
 #ifndef IPCL_INCLUDE_IPCL_PRI_KEY_HPP_
 #define IPCL_INCLUDE_IPCL_PRI_KEY_HPP_
 
+#include <future>  // NOLINT [build/c++11]
 #include <memory>
 #include <utility>
 #include <vector>
@@ -47,6 +48,23 @@ class PrivateKey {
    */
   PlainText decrypt(const CipherText& ciphertext) const;
 
+  /**
+   * Decrypt ciphertext asynchronously on the default executor
+   * @param[in] ciphertext CipherText to be decrypted
+   * @return future of the plaintext
+   */
+  std::future<PlainText> decryptAsync(const CipherText& ciphertext) const;
+
+  /**
+   * Encrypt plaintext with the private key
+   * The obfuscator r^n mod n^2 is computed modulo p^2 and q^2 and recombined
+   * by CRT, the ciphertexts are the same as the ones of PublicKey::encrypt
+   * @param[in] pt PlainText to be encrypted
+   * @param[in] make_secure apply obfuscator(random value)
+   * @return ciphertext of type CipherText
+   */
+  CipherText encrypt(const PlainText& pt, bool make_secure = true) const;
+
   const void* addr = static_cast<const void*>(this);
 
   /**
@@ -83,6 +101,7 @@ class PrivateKey {
   std::shared_ptr<BigNumber> m_n;
   std::shared_ptr<BigNumber> m_nsquare;
   std::shared_ptr<BigNumber> m_g;
+  std::shared_ptr<const PublicKey> m_pk;
   std::shared_ptr<BigNumber> m_p;
   std::shared_ptr<BigNumber> m_q;
 
@@ -91,6 +110,9 @@ class PrivateKey {
   BigNumber m_psquare;
   BigNumber m_qsquare;
   BigNumber m_pinverse;
+  BigNumber m_psquareinverse;
+  BigNumber m_pexp;
+  BigNumber m_qexp;
   BigNumber m_hp;
   BigNumber m_hq;
   BigNumber m_lambda;
@@ -113,12 +135,20 @@ class PrivateKey {
   BigNumber computeHfun(const BigNumber& a, const BigNumber& b) const;
 
   /**
-   * Compute CRT function in paillier scheme
+   * Compute CRT function in paillier scheme for a batch
+   * @param[out] res CRT results, sized to the batch
    * @param[in] mp input mp
    * @param[in] mq input mq
-   * @return the CRT result of type BigNumber
    */
-  BigNumber computeCRT(const BigNumber& mp, const BigNumber& mq) const;
+  void computeCRT(std::vector<BigNumber>& res, const std::vector<BigNumber>& mp,
+                  const std::vector<BigNumber>& mq) const;
+
+  /**
+   * Compute the obfuscators r^n mod n^2 modulo p^2 and q^2
+   * @param[in] sz number of obfuscators
+   * @return the obfuscators of type BigNumber vector
+   */
+  std::vector<BigNumber> getObfuscatorCRT(std::size_t sz) const;
 
   /**
    * Raw decryption function without CRT optimization
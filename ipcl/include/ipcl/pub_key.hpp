@@ -4,12 +4,16 @@
 #ifndef IPCL_INCLUDE_IPCL_PUB_KEY_HPP_
 #define IPCL_INCLUDE_IPCL_PUB_KEY_HPP_
 
+#include <future>  // NOLINT [build/c++11]
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "ipcl/bignum.h"
+#include "ipcl/fixed_base_exp.hpp"
+#include "ipcl/obfuscator_pool.hpp"
 #include "ipcl/plaintext.hpp"
+#include "ipcl/utils/common.hpp"
 
 namespace ipcl {
 
@@ -59,6 +63,15 @@ class PublicKey {
    */
   CipherText encrypt(const PlainText& plaintext, bool make_secure = true) const;
 
+  /**
+   * Encrypt plaintext asynchronously on the default executor
+   * @param[in] plaintext of type PlainText
+   * @param[in] make_secure apply obfuscator(default value is true)
+   * @return future of the ciphertext
+   */
+  std::future<CipherText> encryptAsync(const PlainText& plaintext,
+                                       bool make_secure = true) const;
+
   /**
    * Get N of public key in paillier scheme
    */
@@ -98,6 +111,30 @@ class PublicKey {
 
   void setHS(const BigNumber& hs);
 
+  /**
+   * Precompute obfuscators on background threads, so that encrypt only
+   * applies them with a modular multiplication
+   * @param[in] capacity maximum number of precomputed obfuscators
+   * @param[in] low_water_mark refill the pool below this number
+   * @param[in] num_threads number of background refill threads
+   */
+  void enableObfuscatorPool(
+      std::size_t capacity = IPCL_OBFUSCATOR_POOL_CAPACITY,
+      std::size_t low_water_mark = IPCL_OBFUSCATOR_POOL_LOW_WATER_MARK,
+      int num_threads = 1);
+
+  /**
+   * Stop the obfuscator pool, obfuscators are computed inline again
+   */
+  void disableObfuscatorPool();
+
+  /**
+   * Get the obfuscator pool, nullptr if not enabled
+   */
+  std::shared_ptr<ObfuscatorPool> getObfuscatorPool() const {
+    return m_obf_pool;
+  }
+
   /**
    * Check if using DJN scheme
    */
@@ -122,7 +159,15 @@ class PublicKey {
   /**
    * Check whether pub key is initialized
    */
-  bool isInitialized() { return m_isInitialized; }
+  bool isInitialized() const { return m_isInitialized; }
+
+  /**
+   * Get the shared immutable handle of the key referenced by ciphertexts.
+   * Keys are interned by n and the DJN parameters, so that all the keys with
+   * the same parameters share one handle and comparing handles compares keys.
+   * The handle is refreshed whenever the parameters change.
+   */
+  std::shared_ptr<const PublicKey> getHandle() const;
 
   void create(const BigNumber& n, int bits, bool enableDJN_ = false);
   void create(const BigNumber& n, int bits, const BigNumber& hs, int randbits);
@@ -167,8 +212,22 @@ class PublicKey {
   BigNumber m_hs;
   int m_randbits;
   bool m_enable_DJN;
+  std::shared_ptr<FixedBaseModExp> m_hs_table;  ///< Powers of hs mod n^2
+  std::shared_ptr<ObfuscatorPool> m_obf_pool;   ///< Precomputed obfuscators
   std::vector<BigNumber> m_r;
   bool m_testv;
+  std::shared_ptr<const PublicKey> m_handle;  ///< Interned copy of the key
+  std::weak_ptr<const PublicKey> m_self;      ///< Set on the interned copy
+
+  /**
+   * Look up or create the interned copy of the key
+   */
+  std::shared_ptr<const PublicKey> intern() const;
+
+  /**
+   * Replace the handle after a change of the key parameters
+   */
+  void reintern();
 
   /**
    * Big number vector multi buffer encryption
@@ -179,9 +238,21 @@ class PublicKey {
   std::vector<BigNumber> raw_encrypt(const std::vector<BigNumber>& pt,
                                      bool make_secure = true) const;
 
+  /**
+   * Precompute the fixed-base table of hs used by DJN obfuscator
+   */
+  void initDJNTable();
+
   std::vector<BigNumber> getDJNObfuscator(std::size_t sz) const;
 
   std::vector<BigNumber> getNormalObfuscator(std::size_t sz) const;
+
+  std::vector<BigNumber> getObfuscator(std::size_t sz) const;
+
+  /**
+   * Restart the obfuscator pool after the key parameters changed
+   */
+  void restartObfuscatorPool();
 };
 
 }  // namespace ipcl
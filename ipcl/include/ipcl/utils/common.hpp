@@ -4,11 +4,15 @@
 #ifndef IPCL_INCLUDE_IPCL_UTILS_COMMON_HPP_
 #define IPCL_INCLUDE_IPCL_UTILS_COMMON_HPP_
 
+#include <vector>
+
 #include "ipcl/bignum.h"
 
 namespace ipcl {
 
 constexpr int IPCL_CRYPTO_MB_SIZE = 8;
+constexpr int IPCL_CRYPTO_MB_MAX_MOD_BITS = 4096;  // mbx_exp_mb8 limit
+constexpr int IPCL_MB_MONT_MAX_MOD_BITS = 8192;    // mbMontMul limit
 constexpr int IPCL_QAT_MODEXP_BATCH_SIZE = 1024;
 
 constexpr int IPCL_WORKLOAD_SIZE_THRESHOLD = 128;
@@ -17,6 +21,37 @@ constexpr float IPCL_HYBRID_MODEXP_RATIO_FULL = 1.0;
 constexpr float IPCL_HYBRID_MODEXP_RATIO_ENCRYPT = 0.25;
 constexpr float IPCL_HYBRID_MODEXP_RATIO_DECRYPT = 0.12;
 constexpr float IPCL_HYBRID_MODEXP_RATIO_MULTIPLY = 0.18;
+constexpr float IPCL_HYBRID_MODEXP_RATIO_OTHER = 0.5;
+
+constexpr int IPCL_HYBRID_ADAPTIVE_BUCKETS = 24;
+constexpr double IPCL_HYBRID_ADAPTIVE_ALPHA = 0.25;
+
+constexpr int IPCL_OBFUSCATOR_POOL_CAPACITY = 1024;
+constexpr int IPCL_OBFUSCATOR_POOL_LOW_WATER_MARK = 256;
+constexpr int IPCL_OBFUSCATOR_POOL_BATCH_SIZE = 64;
+
+constexpr int IPCL_ASYNC_NUM_THREADS = 4;
+
+constexpr int IPCL_MONT_CACHE_SIZE = 8;
+constexpr int IPCL_MONT_SLIDING_WINDOW_THRESHOLD = 64;
+
+constexpr int IPCL_BIGNUM_POOL_CLASSES = 10;  // up to 2^9 words (16384 bits)
+constexpr int IPCL_BIGNUM_POOL_DEPTH = 64;
+
+constexpr int IPCL_PACKED_BIGNUM_ALIGNMENT = 64;  // bytes, one cache line
+
+constexpr int IPCL_MULTI_EXP_MIN_PART_SIZE = 64;
+constexpr int IPCL_MOD_PROD_MIN_PART_SIZE = 64;
+
+constexpr int IPCL_KEYGEN_SIEVE_BOUND = 1 << 14;   // largest sieving prime
+constexpr int IPCL_KEYGEN_SIEVE_WINDOW = 1 << 12;  // candidates per window
+constexpr int IPCL_KEYGEN_PRIME_TRIALS = 10;       // Miller-Rabin rounds
+
+constexpr int IPCL_DRBG_BUFFER_BLOCKS = 64;       // 4KB of keystream per refill
+constexpr int IPCL_DRBG_RESEED_INTERVAL = 1024;  // refills between reseeds
+constexpr int IPCL_DRBG_ENTROPY_RETRIES = 10;    // RDSEED/RDRAND underflows
+
+constexpr int IPCL_ENCODER_MAX_SLOT_BITS = 62;  // a slot and its carry in int64
 
 /**
  * Random generator wrapper.Generates a random unsigned Big Number of the
@@ -39,11 +74,28 @@ IppStatus ippGenRandom(Ipp32u* rand, int bits, void* ctx);
 IppStatus ippGenRandomBN(IppsBigNumState* rand, int bits, void* ctx);
 
 /**
- * Get random value
+ * Get random value from the DRBG of the calling thread
  * @param[in] bits The number of Big Number bits
  * @return The random value of type Big Number
  */
 BigNumber getRandomBN(int bits);
 
+/**
+ * Get random values, the random limbs of the whole batch are drawn at once
+ * @param[in] sz The number of values
+ * @param[in] bits The number of Big Number bits
+ * @return The random values of type Big Number
+ */
+std::vector<BigNumber> getRandomBNs(std::size_t sz, int bits);
+
+/**
+ * Get random values uniformly distributed in [1, bound), by rejection of the
+ * out of range draws instead of a modular reduction
+ * @param[in] sz The number of values
+ * @param[in] bound The exclusive upper bound, greater than 1
+ * @return The random values of type Big Number
+ */
+std::vector<BigNumber> getRandomBNBelow(std::size_t sz, const BigNumber& bound);
+
 }  // namespace ipcl
 #endif  // IPCL_INCLUDE_IPCL_UTILS_COMMON_HPP_
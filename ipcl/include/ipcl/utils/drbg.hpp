@@ -0,0 +1,70 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_UTILS_DRBG_HPP_
+#define IPCL_INCLUDE_IPCL_UTILS_DRBG_HPP_
+
+#include <array>
+#include <vector>
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Per-thread ChaCha20 random bit generator with fast key erasure.
+ * Every refill runs ChaCha20 over a whole buffer of blocks, the first 256
+ * bits of the keystream replace the key and the rest is handed out, so that
+ * the state never allows recovering past output. The key is seeded from the
+ * entropy source of ippGenRandom (RDSEED, RDRAND or the IPP PRNG, itself
+ * seeded from std::random_device) and mixed with fresh entropy every
+ * IPCL_DRBG_RESEED_INTERVAL refills, and in the child of a fork so that it
+ * does not replay the output of its parent.
+ */
+class DRBG {
+ public:
+  DRBG(const DRBG&) = delete;
+  DRBG& operator=(const DRBG&) = delete;
+
+  /**
+   * Get the generator of the calling thread, seeded on first use
+   */
+  static DRBG& getInstance();
+
+  /**
+   * Fill a buffer with random bits
+   * @param[out] out output words
+   * @param[in] words number of words
+   */
+  void generate(Ipp32u* out, std::size_t words);
+
+  /**
+   * Mix fresh entropy into the key and discard the buffered output
+   */
+  void reseed();
+
+ private:
+  DRBG();
+
+  void refill();
+
+  /**
+   * Draw words from the entropy source
+   */
+  void getEntropy(Ipp32u* out, int words);
+
+  /**
+   * Seed the IPP PRNG of the software entropy source
+   */
+  void seedPRNG();
+
+  std::array<Ipp32u, 8> m_key;
+  std::vector<Ipp32u> m_buffer;
+  std::size_t m_pos;
+  std::size_t m_refills;
+  std::vector<Ipp8u> m_prng;  ///< IppsPRNGState, without RDSEED and RDRAND
+  Ipp64u m_fork_generation;   ///< Forks seen when last seeded
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_UTILS_DRBG_HPP_
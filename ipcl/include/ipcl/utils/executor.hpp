@@ -0,0 +1,81 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_UTILS_EXECUTOR_HPP_
+#define IPCL_INCLUDE_IPCL_UTILS_EXECUTOR_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT [build/c++11]
+#include <memory>
+#include <mutex>
+#include <thread>  // NOLINT [build/c++11]
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ipcl {
+
+/**
+ * Persistent pool of worker threads running submitted tasks in FIFO order.
+ * Workers are created once and live until the executor is destroyed, which
+ * runs the remaining queued tasks before joining them.
+ */
+class Executor {
+ public:
+  Executor() = delete;
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  /**
+   * Executor constructor
+   * @param[in] num_threads number of worker threads
+   * @param[in] first_cpu pin worker i to CPU first_cpu + i, -1 (default)
+   * leaves the workers unpinned
+   */
+  explicit Executor(int num_threads, int first_cpu = -1);
+
+  /**
+   * Executor destructor, drains the queue and joins the workers
+   */
+  ~Executor();
+
+  /**
+   * Submit a task
+   * @param[in] f callable without arguments
+   * @return future holding the result or the exception thrown by f
+   */
+  template <typename F>
+  std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& f) {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    std::future<R> res = task->get_future();
+    enqueue([task] { (*task)(); });
+    return res;
+  }
+
+  /**
+   * Get the number of worker threads
+   */
+  int getThreadCount() const { return static_cast<int>(m_threads.size()); }
+
+  /**
+   * Get the executor shared by the asynchronous API of the library
+   */
+  static Executor& getDefault();
+
+ private:
+  void enqueue(std::function<void()> task);
+  void run();
+  void stop();
+
+  std::deque<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop;
+  std::vector<std::thread> m_threads;
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_UTILS_EXECUTOR_HPP_
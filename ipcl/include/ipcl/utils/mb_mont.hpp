@@ -0,0 +1,103 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_UTILS_MB_MONT_HPP_
+#define IPCL_INCLUDE_IPCL_UTILS_MB_MONT_HPP_
+
+#include <vector>
+
+#include "ipcl/bignum.h"
+#include "ipcl/packed_bignum.hpp"
+
+namespace ipcl {
+
+/**
+ * Radix 2^52 digits of IPCL_CRYPTO_MB_SIZE lanes, digit j of the lanes is
+ * stored at [8 * j, 8 * j + 8)
+ */
+using MBDigits = std::vector<Ipp64u, AlignedAllocator<Ipp64u>>;
+
+/**
+ * Modulus dependent constants of the 8-lane Montgomery multiplication, in
+ * radix 2^52 with R = 2^(52 * digits)
+ */
+struct MBMontContext {
+  int digits;
+  MBDigits mod;  ///< modulus digits
+  Ipp64u k0;     ///< -mod^-1 mod 2^52
+  MBDigits rr;   ///< R^2 mod m, broadcast to the 8 lanes
+};
+
+/**
+ * Create the 8-lane Montgomery constants of a modulus
+ * @param[in] mod odd modulus
+ */
+MBMontContext createMBMontContext(const BigNumber& mod);
+
+/**
+ * Split an operand into the digits of one lane, operands not less than the
+ * modulus or negative are reduced first to keep the Montgomery bounds
+ * @param[in] bn operand
+ * @param[in] mod odd modulus
+ * @param[in] digits number of digits of the modulus
+ * @param[out] lane first digit of the lane
+ */
+void toMBLane(const BigNumber& bn, const BigNumber& mod, int digits,
+              Ipp64u* lane);
+
+/**
+ * Split an operand into 2 * digits digits of one lane for mbMontRedc,
+ * operands not less than mod * R or negative are reduced first
+ * @param[in] bn operand
+ * @param[in] mod odd modulus
+ * @param[in] digits number of digits of the modulus
+ * @param[out] lane first digit of the lane
+ */
+void toMBLaneWide(const BigNumber& bn, const BigNumber& mod, int digits,
+                  Ipp64u* lane);
+
+/**
+ * Join the digits of one lane into a big number
+ * @param[in] lane first digit of the lane
+ * @param[in] digits number of digits
+ */
+BigNumber fromMBLane(const Ipp64u* lane, int digits);
+
+/**
+ * 8-lane Montgomery multiplication res = a * b * R^-1 mod m on the
+ * AVX512-IFMA units. The operands are less than the modulus, res may alias
+ * them.
+ * @param[out] res result lanes
+ * @param[in] a first operand lanes
+ * @param[in] b second operand lanes
+ * @param[in] ctx Montgomery constants
+ * @param[in] acc_buff scratch of 8 * (digits + 1) limbs, 64-byte aligned
+ */
+void mbMontMul(Ipp64u* res, const Ipp64u* a, const Ipp64u* b,
+               const MBMontContext& ctx, Ipp64u* acc_buff);
+
+/**
+ * 8-lane Montgomery reduction res = t * R^-1 mod m of double-width operands
+ * less than m * R, such as the products of two operands less than m
+ * @param[out] res result lanes
+ * @param[in] t operand lanes of 2 * digits digits
+ * @param[in] ctx Montgomery constants
+ * @param[in] acc_buff scratch of 8 * 2 * digits limbs, 64-byte aligned
+ */
+void mbMontRedc(Ipp64u* res, const Ipp64u* t, const MBMontContext& ctx,
+                Ipp64u* acc_buff);
+
+/**
+ * Gather table[idx[lane]] into every lane, reading all the entries so that
+ * the memory access pattern does not depend on the indices
+ * @param[out] res result lanes
+ * @param[in] table entries of 8 * digits limbs each
+ * @param[in] entries number of entries
+ * @param[in] idx entry index of each lane
+ * @param[in] digits number of digits
+ */
+void mbSelect(Ipp64u* res, const Ipp64u* table, int entries,
+              const Ipp64u* idx, int digits);
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_UTILS_MB_MONT_HPP_
@@ -0,0 +1,59 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_UTILS_MONT_CACHE_HPP_
+#define IPCL_INCLUDE_IPCL_UTILS_MONT_CACHE_HPP_
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Get the Montgomery engine of the calling thread for a modulus.
+ * Engines are initialized once per thread, modulus and method and kept in a
+ * small thread-local LRU cache, so the long-lived moduli of a key (n^2, p^2,
+ * q^2) never pay the setup cost again. The engine holds its own scratch
+ * buffer and must not be shared with other threads.
+ * @param[in] mod odd modulus
+ * @param[in] method exponentiation method of the engine
+ * @return pointer to the cached engine, valid until evicted from the cache
+ */
+IppsMontState* getMontState(const BigNumber& mod,
+                            IppsExpMethod method = IppsBinaryMethod);
+
+/**
+ * Select the exponentiation method for an exponent bit length
+ * @param[in] exp_bits bit length of the exponent
+ * @return IppsSlidingWindows for long exponents, IppsBinaryMethod otherwise
+ */
+IppsExpMethod getMontExpMethod(int exp_bits);
+
+/**
+ * Montgomery multiplication, computes a * b * R^-1 mod m
+ * @param[in] a first operand less than the modulus
+ * @param[in] b second operand less than the modulus
+ * @param[in] mod odd modulus
+ */
+BigNumber montMul(const BigNumber& a, const BigNumber& b, const BigNumber& mod);
+
+/**
+ * Convert into Montgomery form, computes a * R mod m
+ * @param[in] a value less than the modulus
+ * @param[in] mod odd modulus
+ */
+BigNumber toMontForm(const BigNumber& a, const BigNumber& mod);
+
+/**
+ * Convert out of Montgomery form, computes a * R^-1 mod m
+ * @param[in] a Montgomery form value
+ * @param[in] mod odd modulus
+ */
+BigNumber fromMontForm(const BigNumber& a, const BigNumber& mod);
+
+/**
+ * Release the Montgomery engines cached by the calling thread
+ */
+void clearMontCache();
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_UTILS_MONT_CACHE_HPP_
@@ -1,16 +1,33 @@
 // Copyright (C) 2021 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <atomic>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "ipcl/ipcl.hpp"
+#include "ipcl/utils/util.hpp"
 
 namespace ipcl {
 
-constexpr int N_BIT_SIZE_MAX = 2048;
+constexpr int N_BIT_SIZE_MAX = 4096;
 constexpr int N_BIT_SIZE_MIN = 200;
 
-BigNumber getPrimeBN(int max_bits) {
+static BigNumber getPowerOfTwo(uint64_t count) {
+  uint64_t ct32 = count / 32;   // number of 2**32 needed
+  uint64_t res = count & 0x1F;  // count % 32
+  std::vector<Ipp32u> tmp(ct32 + 1, 0);
+  tmp[ct32] = 1 << res;
+
+  return BigNumber(tmp.data(), tmp.size());
+}
+
+// Smallest bit length searched by sieving, below it a candidate could be
+// one of the sieving primes
+constexpr int SIEVE_MIN_BITS = 32;
+
+static BigNumber ippPrimeGen(int max_bits) {
   int prime_size;
   ippsPrimeGetSize(max_bits, &prime_size);
   auto prime_ctx = std::vector<Ipp8u>(prime_size);
@@ -26,7 +43,7 @@ BigNumber getPrimeBN(int max_bits) {
 
   BigNumber prime_bn(0, max_bits / 8);
   while (ippStsNoErr !=
-         ippsPrimeGen_BN(prime_bn, max_bits, 10,
+         ippsPrimeGen_BN(prime_bn, max_bits, IPCL_KEYGEN_PRIME_TRIALS,
                          reinterpret_cast<IppsPrimeState*>(prime_ctx.data()),
                          ippGenRandom,
                          reinterpret_cast<IppsPRNGState*>(rand_param))) {
@@ -35,15 +52,133 @@ BigNumber getPrimeBN(int max_bits) {
   return prime_bn;
 }
 
-static BigNumber getPrimeDistance(int64_t key_size) {
-  uint64_t count = key_size / 2 - 100;
-  uint64_t ct32 = count / 32;   // number of 2**32 needed
-  uint64_t res = count & 0x1F;  // count % 32
-  std::vector<Ipp32u> tmp(ct32 + 1, 0);
-  tmp[ct32] = 1 << res;
+// Odd primes up to IPCL_KEYGEN_SIEVE_BOUND
+static const std::vector<Ipp32u>& getSievePrimes() {
+  static const std::vector<Ipp32u> primes = [] {
+    std::vector<bool> composite(IPCL_KEYGEN_SIEVE_BOUND + 1, false);
+    std::vector<Ipp32u> res;
+    for (Ipp32u i = 3; i <= IPCL_KEYGEN_SIEVE_BOUND; i += 2) {
+      if (composite[i]) continue;
+      res.push_back(i);
+      for (Ipp32u j = i * i; j <= IPCL_KEYGEN_SIEVE_BOUND; j += 2 * i)
+        composite[j] = true;
+    }
+    return res;
+  }();
+  return primes;
+}
 
-  BigNumber ref_dist(tmp.data(), tmp.size());
-  return ref_dist;
+static Ipp32u modSmall(const BigNumber& bn, Ipp32u m) {
+  int bits;
+  Ipp32u* data;
+  ippsRef_BN(nullptr, &bits, &data, BN(bn));
+  Ipp64u r = 0;
+  for (int i = BITSIZE_WORD(bits) - 1; i >= 0; i--)
+    r = ((r << 32) | data[i]) % m;
+  return static_cast<Ipp32u>(r);
+}
+
+// Miller-Rabin tester of one search thread
+class PrimeTester {
+ public:
+  explicit PrimeTester(int bits) {
+    int prime_size;
+    ippsPrimeGetSize(bits, &prime_size);
+    m_prime_ctx.resize(prime_size);
+    ippsPrimeInit(bits, ctx());
+#if !defined(IPCL_RNG_INSTR_RDSEED) && !defined(IPCL_RNG_INSTR_RDRAND)
+    int prng_size;
+    ippsPRNGGetSize(&prng_size);
+    m_rand_param.resize(prng_size);
+    ippsPRNGInit(160, reinterpret_cast<IppsPRNGState*>(m_rand_param.data()));
+#endif
+  }
+
+  bool isPrime(const BigNumber& bn) {
+    Ipp32u res = IPP_IS_COMPOSITE;
+    IppStatus stat = ippsPrimeTest_BN(
+        BN(bn), IPCL_KEYGEN_PRIME_TRIALS, &res, ctx(), ippGenRandom,
+        m_rand_param.empty() ? nullptr : m_rand_param.data());
+    ERROR_CHECK(stat == ippStsNoErr,
+                std::string("ippsPrimeTest_BN: error code = ") +
+                    std::to_string(stat));
+    return res == IPP_IS_PRIME;
+  }
+
+ private:
+  IppsPrimeState* ctx() {
+    return reinterpret_cast<IppsPrimeState*>(m_prime_ctx.data());
+  }
+
+  std::vector<Ipp8u> m_prime_ctx;
+  std::vector<Ipp8u> m_rand_param;
+};
+
+// Sieve one window of candidates c0 + step * k from a random start and test
+// the survivors, returns zero when the window holds no prime. The two top
+// bits of the start are set, so that the product of two such primes has
+// exactly twice their bit length. With blum, the candidates are 3 mod 4.
+static BigNumber searchPrimeWindow(int bits, bool blum, PrimeTester& tester,
+                                   const std::atomic<bool>& found) {
+  const Ipp32u step = blum ? 4 : 2;
+  BigNumber c0 = getRandomBN(bits);
+  BigNumber top = getPowerOfTwo(bits - 2);
+  c0 = (c0 % top) + top + top + top;  // set the top two bits
+  c0 = c0 - BigNumber(modSmall(c0, step)) + (blum ? 3 : 1);
+
+  std::vector<bool> sieved(IPCL_KEYGEN_SIEVE_WINDOW, false);
+  for (Ipp32u s : getSievePrimes()) {
+    // first k with s | c0 + step * k
+    Ipp64u r = modSmall(c0, s);
+    Ipp64u inv2 = (s + 1) / 2;  // 2^-1 mod s
+    Ipp64u inv = (step == 4) ? inv2 * inv2 % s : inv2;
+    Ipp64u k = (s - r) % s * inv % s;
+    for (; k < IPCL_KEYGEN_SIEVE_WINDOW; k += s) sieved[k] = true;
+  }
+
+  for (int k = 0; k < IPCL_KEYGEN_SIEVE_WINDOW && !found; k++) {
+    if (sieved[k]) continue;
+    BigNumber c = c0 + BigNumber(static_cast<Ipp32u>(step * k));
+    if (c.BitSize() > bits) break;
+    if (tester.isPrime(c)) return c;
+  }
+  return BigNumber::Zero();
+}
+
+// Search a prime of the given bit length on all the OMP threads, each
+// sieving and testing its own windows until one of them succeeds
+static BigNumber searchPrime(int bits, bool blum) {
+  std::atomic<bool> found(false);
+  std::mutex mutex;
+  BigNumber prime;
+
+  int num_threads = 1;
+#ifdef IPCL_USE_OMP
+  num_threads = OMPUtilities::MaxThreads;
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_threads))
+#endif  // IPCL_USE_OMP
+  for (int t = 0; t < num_threads; t++) {
+    PrimeTester tester(bits);
+    while (!found) {
+      BigNumber c = searchPrimeWindow(bits, blum, tester, found);
+      if (c != BigNumber::Zero() && !found.exchange(true)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        prime = c;
+      }
+    }
+  }
+  return prime;
+}
+
+BigNumber getPrimeBN(int max_bits) {
+  if (max_bits < SIEVE_MIN_BITS) return ippPrimeGen(max_bits);
+  return searchPrime(max_bits, false);
+}
+
+static BigNumber getPrimeDistance(int64_t key_size) {
+  return getPowerOfTwo(key_size / 2 - 100);
 }
 
 static bool isClosePrimeBN(const BigNumber& p, const BigNumber& q,
@@ -52,46 +187,37 @@ static bool isClosePrimeBN(const BigNumber& p, const BigNumber& q,
   return (real_dist > ref_dist) ? false : true;
 }
 
+// p is kept once found, only q is searched again when a check fails
 static void getNormalBN(int64_t n_length, BigNumber& p, BigNumber& q,
                         BigNumber& n, const BigNumber& ref_dist) {
-  for (int64_t len = 0; (len != n_length) || isClosePrimeBN(p, q, ref_dist);
-       len = n.BitSize()) {
-    p = getPrimeBN(n_length / 2);
-    q = p;
-    while (q == p) {
-      q = getPrimeBN(n_length / 2);
-    }
+  p = searchPrime(n_length / 2, false);
+  do {
+    q = searchPrime(n_length / 2, false);
     n = p * q;
-  }
+  } while (q == p || (n.BitSize() != n_length) ||
+           isClosePrimeBN(p, q, ref_dist));
 }
 
 static void getDJNBN(int64_t n_length, BigNumber& p, BigNumber& q, BigNumber& n,
                      BigNumber& ref_dist) {
   BigNumber gcd;
+  p = searchPrime(n_length / 2, true);  // p mod 4 = 3
   do {
-    do {
-      p = getPrimeBN(n_length / 2);
-    } while (!p.TestBit(1));  // get p: p mod 4 = 3
-
-    do {
-      q = getPrimeBN(n_length / 2);
-    } while (q == p || !p.TestBit(1));  // get q: q!=p and q mod 4 = 3
-
-    gcd = (p - 1).gcd(q - 1);  // (p - 1) is a BigNumber
+    q = searchPrime(n_length / 2, true);  // q mod 4 = 3
+    gcd = (p - 1).gcd(q - 1);             // (p - 1) is a BigNumber
     n = p * q;
-  } while ((gcd.compare(2)) || (n.BitSize() != n_length) ||
+  } while (q == p || (gcd.compare(2)) || (n.BitSize() != n_length) ||
            isClosePrimeBN(p, q, ref_dist));  // gcd(p-1,q-1)=2
 }
 
 KeyPair generateKeypair(int64_t n_length, bool enable_DJN) {
   /*
   https://www.intel.com/content/www/us/en/develop/documentation/ipp-crypto-reference/top/multi-buffer-cryptography-functions/modular-exponentiation/mbx-exp-1024-2048-3072-4096-mb8.html
-  modulus size = n * n (keySize * keySize )
+  modulus size = n * n (keySize * keySize ), moduli beyond the 4Kb limit of
+  mbx_exp_mb8 (3Kb and 4Kb keys) run on the wide multi-buffer engine
   */
-  ERROR_CHECK(
-      n_length <= N_BIT_SIZE_MAX,
-      "generateKeyPair: modulus size in bits should belong to either 1Kb, 2Kb, "
-      "3Kb or 4Kb range only, key size exceed the range!!!");
+  ERROR_CHECK(n_length <= N_BIT_SIZE_MAX,
+              "generateKeyPair: key size should not exceed 4096 bits");
   ERROR_CHECK((n_length >= N_BIT_SIZE_MIN) && (n_length % 4 == 0),
               "generateKeyPair: key size should >=200, and divisible by 4");
 
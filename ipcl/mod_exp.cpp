@@ -4,9 +4,14 @@
 #include "ipcl/mod_exp.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <thread>  //NOLINT
+#include <utility>
 
 #include "crypto_mb/exp.h"
 
@@ -15,14 +20,17 @@
 #include <heqat/common.h>
 #endif
 
+#include "ipcl/fixed_exponent_exp.hpp"
+#include "ipcl/hybrid_controller.hpp"
+#include "ipcl/utils/executor.hpp"
+#include "ipcl/utils/mb_mont.hpp"
+#include "ipcl/utils/mont_cache.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
 
-static thread_local struct {
-  float ratio;
-  HybridMode mode;
-} g_hybrid_params = {0.0, HybridMode::OPTIMAL};
+static thread_local HybridParams g_hybrid_params = {0.0,
+                                                    HybridMode::OPTIMAL};
 
 static inline float scale_down(int value, float scale = 100.0) {
   return value / scale;
@@ -33,26 +41,23 @@ static inline int scale_up(float value, int scale = 100) {
 }
 
 void setHybridRatio(float ratio, bool reset_mode) {
-#ifdef IPCL_USE_QAT
   ERROR_CHECK((ratio <= 1.0) && (ratio >= 0),
               "setHybridRatio: Hybrid modexp qat ratio is NOT correct");
   g_hybrid_params.ratio = ratio;
   if (reset_mode) g_hybrid_params.mode = HybridMode::UNDEFINED;
-#endif  // IPCL_USE_QAT
 }
 
 void setHybridMode(HybridMode mode) {
-#ifdef IPCL_USE_QAT
   int mode_value = static_cast<std::underlying_type<HybridMode>::type>(mode);
-  float ratio = scale_down(mode_value);
-  g_hybrid_params = {ratio, mode};
-#endif  // IPCL_USE_QAT
+  // The ADAPTIVE ratio is owned by the HybridController
+  g_hybrid_params.ratio =
+      (mode == HybridMode::ADAPTIVE) ? 0.0 : scale_down(mode_value);
+  g_hybrid_params.mode = mode;
 }
 
 void setHybridOff() {
-#ifdef IPCL_USE_QAT
-  g_hybrid_params = {0.0, HybridMode::UNDEFINED};
-#endif  // IPCL_USE_QAT
+  g_hybrid_params.ratio = 0.0;
+  g_hybrid_params.mode = HybridMode::UNDEFINED;
 }
 
 float getHybridRatio() { return g_hybrid_params.ratio; }
@@ -63,18 +68,58 @@ bool isHybridOptimal() {
   return (g_hybrid_params.mode == HybridMode::OPTIMAL) ? true : false;
 }
 
+bool isHybridAdaptive() {
+  return (g_hybrid_params.mode == HybridMode::ADAPTIVE) ? true : false;
+}
+
+HybridParams getHybridParams() { return g_hybrid_params; }
+
+void setHybridParams(const HybridParams& params) { g_hybrid_params = params; }
+
+HybridOpScope::HybridOpScope(HybridOp op) : m_prev(g_hybrid_params.op) {
+  g_hybrid_params.op = op;
+}
+
+HybridOpScope::~HybridOpScope() { g_hybrid_params.op = m_prev; }
+
+namespace {
+
+// Read-only operands of a batched exponentiation. A stride of 0 broadcasts a
+// single value (e.g. the shared modulus of a key) to every element.
+struct BNRange {
+  const BigNumber* data;
+  std::size_t stride;
+
+  const BigNumber& operator[](std::size_t i) const { return data[i * stride]; }
+  BNRange operator+(std::size_t i) const { return {data + i * stride, stride}; }
+};
+
+BNRange toRange(const std::vector<BigNumber>& v) { return {v.data(), 1}; }
+BNRange toRange(const BigNumber& bn) { return {&bn, 0}; }
+
+}  // namespace
+
+// Persistent thread driving the accelerator share of hybrid modExp,
+// optionally pinned to the CPU given by the IPCL_HYBRID_QAT_CPU environment
+// variable
+static Executor& getHybridExecutor() {
+  static const char* cpu = std::getenv("IPCL_HYBRID_QAT_CPU");
+  static Executor executor(1, cpu ? std::atoi(cpu) : -1);
+  return executor;
+}
+
 #ifdef IPCL_USE_QAT
-// Multiple input QAT ModExp interface to offload computation to QAT
-static std::vector<BigNumber> heQatBnModExp(
-    const std::vector<BigNumber>& base, const std::vector<BigNumber>& exponent,
-    const std::vector<BigNumber>& modulus, unsigned int batch_size) {
+// Multiple input QAT ModExp interface to offload computation to QAT, writes
+// worksize results to remainder
+static void heQatBnModExp(BNRange base, BNRange exponent, BNRange modulus,
+                          unsigned int worksize, unsigned int batch_size,
+                          BigNumber* remainder) {
   static unsigned int counter = 0;
-  int nbits = modulus.front().BitSize();
+  int nbits = modulus[0].BitSize();
   int length = BITSIZE_WORD(nbits) * 4;
   nbits = 8 * length;
 
   // Check if QAT Exec Env supports requested batch size
-  unsigned int worksize = base.size();
   unsigned int nslices = worksize / batch_size;
   unsigned int residue = worksize % batch_size;
 
@@ -125,9 +170,6 @@ static std::vector<BigNumber> heQatBnModExp(
 #endif
   }  // End preparing input containers
 
-  // Container to hold total number of outputs to be returned
-  std::vector<BigNumber> remainder(worksize, 0);
-
   for (unsigned int j = 0; j < nslices; j++) {
     // Prepare batch of input data
     for (unsigned int i = 0; i < batch_size; i++) {
@@ -315,19 +357,40 @@ static std::vector<BigNumber> heQatBnModExp(
     free(bn_remainder_data_[i]);
     bn_remainder_data_[i] = NULL;
   }
-
-  return remainder;
 }
 #endif  // IPCL_USE_QAT
 
-static std::vector<BigNumber> ippMBModExp(const std::vector<BigNumber>& base,
-                                          const std::vector<BigNumber>& exp,
-                                          const std::vector<BigNumber>& mod) {
-  std::size_t real_v_size = base.size();
-  std::size_t pow_v_size = exp.size();
-  std::size_t mod_v_size = mod.size();
-  ERROR_CHECK((real_v_size == pow_v_size) && (pow_v_size == mod_v_size) &&
-                  (real_v_size <= IPCL_CRYPTO_MB_SIZE),
+namespace {
+
+// Per-thread buffers of the multi-buffer exponentiation, grown on demand and
+// reused by every 8-lane call of the thread.
+struct MBModExpWorkspace {
+  std::vector<int64u> out_buff;
+  std::vector<int64u> base_buff;
+  std::vector<int64u> exp_buff;
+  std::vector<int64u> mod_buff;
+  std::vector<Ipp8u> work_buff;
+
+  void reserve(std::size_t num_buff, std::size_t work_buff_size) {
+    if (out_buff.size() < num_buff) {
+      out_buff.resize(num_buff);
+      base_buff.resize(num_buff);
+      exp_buff.resize(num_buff);
+      mod_buff.resize(num_buff);
+    }
+    if (work_buff.size() < work_buff_size) work_buff.resize(work_buff_size);
+  }
+};
+
+thread_local MBModExpWorkspace g_mb_workspace;
+
+}  // namespace
+
+// Compute res[i] = base[i]^exp[i] mod mod[i] for up to IPCL_CRYPTO_MB_SIZE
+// lanes, reading the inputs in place.
+static void ippMBModExp(BNRange base, BNRange exp, BNRange mod,
+                        std::size_t real_v_size, BigNumber* res) {
+  ERROR_CHECK(real_v_size > 0 && real_v_size <= IPCL_CRYPTO_MB_SIZE,
               "ippMBModExp: input vector size error");
 
   mbx_status st = MBX_STATUS_OK;
@@ -338,59 +401,63 @@ static std::vector<BigNumber> ippMBModExp(const std::vector<BigNumber>& base,
    * will be inconsistent with the length allocated by base_pa/exp_pa,
    * resulting in data errors.
    */
-  std::vector<Ipp32u*> base_data(IPCL_CRYPTO_MB_SIZE);
-  std::vector<Ipp32u*> exp_data(IPCL_CRYPTO_MB_SIZE);
-  std::vector<Ipp32u*> mod_data(IPCL_CRYPTO_MB_SIZE);
-  std::vector<int> base_bits_v(IPCL_CRYPTO_MB_SIZE);
-  std::vector<int> exp_bits_v(IPCL_CRYPTO_MB_SIZE);
-  std::vector<int> mod_bits_v(IPCL_CRYPTO_MB_SIZE);
+  std::array<Ipp32u*, IPCL_CRYPTO_MB_SIZE> base_data{};
+  std::array<Ipp32u*, IPCL_CRYPTO_MB_SIZE> exp_data{};
+  std::array<Ipp32u*, IPCL_CRYPTO_MB_SIZE> mod_data{};
+  std::array<int, IPCL_CRYPTO_MB_SIZE> base_bits_v{};
+  std::array<int, IPCL_CRYPTO_MB_SIZE> exp_bits_v{};
+  std::array<int, IPCL_CRYPTO_MB_SIZE> mod_bits_v{};
 
   for (int i = 0; i < real_v_size; i++) {
-    ippsRef_BN(nullptr, &base_bits_v[i],
-               reinterpret_cast<Ipp32u**>(&base_data[i]), base[i]);
-    ippsRef_BN(nullptr, &exp_bits_v[i],
-               reinterpret_cast<Ipp32u**>(&exp_data[i]), exp[i]);
-    ippsRef_BN(nullptr, &mod_bits_v[i], &mod_data[i], mod[i]);
+    ippsRef_BN(nullptr, &base_bits_v[i], &base_data[i], BN(base[i]));
+    ippsRef_BN(nullptr, &exp_bits_v[i], &exp_data[i], BN(exp[i]));
+    ippsRef_BN(nullptr, &mod_bits_v[i], &mod_data[i], BN(mod[i]));
   }
 
   // Find the longest size of module and power
-  auto longest_mod_it = std::max_element(mod_bits_v.begin(), mod_bits_v.end());
-  auto longest_mod_idx = std::distance(mod_bits_v.begin(), longest_mod_it);
-  BigNumber longest_mod = mod[longest_mod_idx];
-  int mod_bits = *longest_mod_it;
+  int mod_bits = *std::max_element(mod_bits_v.begin(), mod_bits_v.end());
   int exp_bits = *std::max_element(exp_bits_v.begin(), exp_bits_v.end());
 
-  std::vector<int64u*> out_pa(IPCL_CRYPTO_MB_SIZE);
-  std::vector<int64u*> base_pa(IPCL_CRYPTO_MB_SIZE);
-  std::vector<int64u*> exp_pa(IPCL_CRYPTO_MB_SIZE);
+  std::array<int64u*, IPCL_CRYPTO_MB_SIZE> out_pa;
+  std::array<int64u*, IPCL_CRYPTO_MB_SIZE> base_pa;
+  std::array<int64u*, IPCL_CRYPTO_MB_SIZE> exp_pa;
+  std::array<int64u*, IPCL_CRYPTO_MB_SIZE> mod_pa;
 
   int mod_dwords = BITSIZE_DWORD(mod_bits);
   int num_buff = IPCL_CRYPTO_MB_SIZE * mod_dwords;
-  std::vector<int64u> out_buff(num_buff);
-  std::vector<int64u> base_buff(num_buff);
-  std::vector<int64u> exp_buff(num_buff);
+  int work_buff_size = mbx_exp_BufferSize(mod_bits);
+
+  MBModExpWorkspace& ws = g_mb_workspace;
+  ws.reserve(num_buff, work_buff_size);
+
+  // The buffers are reused, so clear the leftovers of the previous call
+  std::memset(ws.base_buff.data(), 0, num_buff * sizeof(int64u));
+  std::memset(ws.exp_buff.data(), 0, num_buff * sizeof(int64u));
+  std::memset(ws.mod_buff.data(), 0, num_buff * sizeof(int64u));
 
   for (int i = 0; i < IPCL_CRYPTO_MB_SIZE; i++) {
     auto idx = i * mod_dwords;
-    out_pa[i] = &out_buff[idx];
-    base_pa[i] = &base_buff[idx];
-    exp_pa[i] = &exp_buff[idx];
+    out_pa[i] = &ws.out_buff[idx];
+    base_pa[i] = &ws.base_buff[idx];
+    exp_pa[i] = &ws.exp_buff[idx];
+    mod_pa[i] = (i < real_v_size) ? &ws.mod_buff[idx] : nullptr;
   }
 
+  // The moduli are padded with zeros to whole 64-bit limbs as well, reading
+  // them in place would pick up the word following an odd-length modulus
   for (int i = 0; i < real_v_size; i++) {
     memcpy(base_pa[i], base_data[i], BITSIZE_WORD(base_bits_v[i]) * 4);
     memcpy(exp_pa[i], exp_data[i], BITSIZE_WORD(exp_bits_v[i]) * 4);
+    memcpy(mod_pa[i], mod_data[i], BITSIZE_WORD(mod_bits_v[i]) * 4);
   }
 
-  int work_buff_size = mbx_exp_BufferSize(mod_bits);
-  auto work_buff = std::vector<Ipp8u>(work_buff_size);
   // If actual sizes of modules are different,
   // set the mod_bits parameter equal to maximum size of the actual module in
   // bit size and extend all the modules with zero bits to the mod_bits value.
   // The same is applicable for the exp_bits parameter and actual exponents.
   st = mbx_exp_mb8(out_pa.data(), base_pa.data(), exp_pa.data(), exp_bits,
-                   reinterpret_cast<Ipp64u**>(mod_data.data()), mod_bits,
-                   reinterpret_cast<Ipp8u*>(work_buff.data()), work_buff_size);
+                   mod_pa.data(), mod_bits, ws.work_buff.data(),
+                   work_buff_size);
 
   for (int i = 0; i < real_v_size; i++) {
     ERROR_CHECK(MBX_STATUS_OK == MBX_GET_STS(st, i),
@@ -399,14 +466,99 @@ static std::vector<BigNumber> ippMBModExp(const std::vector<BigNumber>& base,
                     std::to_string(MBX_GET_STS(st, i)));
   }
 
-  // Init res with longest mod value to ensure each
+  // Size each result with the longest mod to ensure each
   // Big number has enough space.
-  std::vector<BigNumber> res(real_v_size, longest_mod);
   for (int i = 0; i < real_v_size; i++) {
-    res[i].Set(reinterpret_cast<Ipp32u*>(out_pa[i]), BITSIZE_WORD(mod_bits),
-               IppsBigNumPOS);
+    res[i] = BigNumber(reinterpret_cast<Ipp32u*>(out_pa[i]),
+                       BITSIZE_WORD(mod_bits), IppsBigNumPOS);
   }
-  return res;
+}
+
+constexpr int WIDE_MB_WINDOW_MAX = 6;
+
+// Pick the window size minimizing the number of multiplications of the fixed
+// window method: one per window plus the table
+static int chooseWideMBWindowBits(int exp_bits) {
+  int best_w = 1;
+  int best_cost = exp_bits + 1;
+  for (int w = 2; w <= WIDE_MB_WINDOW_MAX; w++) {
+    int cost = (exp_bits + w - 1) / w + (1 << w) - 2;
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_w = w;
+    }
+  }
+  return best_w;
+}
+
+static Ipp64u getExpWindow(const Ipp32u* data, int words, int bit_pos,
+                           int w) {
+  int idx = bit_pos >> 5;
+  int shift = bit_pos & 31;
+  if (idx >= words) return 0;
+  Ipp64u digit = data[idx] >> shift;
+  if ((shift + w > 32) && (idx + 1 < words))
+    digit |= static_cast<Ipp64u>(data[idx + 1]) << (32 - shift);
+  return digit & ((1u << w) - 1);
+}
+
+// Compute res[i] = base[i]^exp[i] mod m for up to IPCL_CRYPTO_MB_SIZE lanes
+// sharing a modulus beyond the mbx_exp_mb8 limit, on the 8-lane Montgomery
+// kernel. Fixed window exponentiation whose table entries are gathered in
+// constant time, as the exponent may be secret (e.g. lambda).
+static void ippWideMBModExp(BNRange base, BNRange exp, const BigNumber& mod,
+                            const MBMontContext& ctx, std::size_t real_v_size,
+                            BigNumber* res) {
+  const int n = ctx.digits;
+  const std::size_t lanes_size = n * IPCL_CRYPTO_MB_SIZE;
+
+  // idle lanes compute 0^0
+  MBDigits x(lanes_size, 0), one(lanes_size, 0);
+  std::array<Ipp32u*, IPCL_CRYPTO_MB_SIZE> exp_data{};
+  std::array<int, IPCL_CRYPTO_MB_SIZE> exp_words{};
+  int exp_bits = 1;
+  for (int i = 0; i < real_v_size; i++) {
+    toMBLane(base[i], mod, n, x.data() + i);
+    int bits;
+    ippsRef_BN(nullptr, &bits, &exp_data[i], BN(exp[i]));
+    exp_words[i] = BITSIZE_WORD(bits);
+    exp_bits = std::max(exp_bits, bits);
+  }
+  for (int i = 0; i < IPCL_CRYPTO_MB_SIZE; i++) one[i] = 1;
+
+  const int w = chooseWideMBWindowBits(exp_bits);
+  const int entries = 1 << w;
+
+  // table[k] = x^k * R mod m, table[0] = MontMul(R^2, 1) = R mod m
+  MBDigits table(entries * lanes_size);
+  MBDigits acc(lanes_size + IPCL_CRYPTO_MB_SIZE);
+  mbMontMul(table.data(), ctx.rr.data(), one.data(), ctx, acc.data());
+  mbMontMul(table.data() + lanes_size, x.data(), ctx.rr.data(), ctx,
+            acc.data());
+  for (int k = 2; k < entries; k++)
+    mbMontMul(table.data() + k * lanes_size,
+              table.data() + (k - 1) * lanes_size, table.data() + lanes_size,
+              ctx, acc.data());
+
+  MBDigits r(table.begin(), table.begin() + lanes_size), t(lanes_size);
+  std::array<Ipp64u, IPCL_CRYPTO_MB_SIZE> idx{};
+  int n_windows = (exp_bits + w - 1) / w;
+  for (int win = n_windows - 1; win >= 0; win--) {
+    if (win != n_windows - 1) {
+      for (int j = 0; j < w; j++)
+        mbMontMul(r.data(), r.data(), r.data(), ctx, acc.data());
+    }
+    for (int i = 0; i < real_v_size; i++)
+      idx[i] = getExpWindow(exp_data[i], exp_words[i], win * w, w);
+    mbSelect(t.data(), table.data(), entries, idx.data(), n);
+    mbMontMul(r.data(), r.data(), t.data(), ctx, acc.data());
+  }
+
+  // convert out of Montgomery form
+  mbMontMul(r.data(), r.data(), one.data(), ctx, acc.data());
+
+  for (int i = 0; i < real_v_size; i++)
+    res[i] = fromMBLane(r.data() + i, n);
 }
 
 static BigNumber ippSBModExp(const BigNumber& base, const BigNumber& exp,
@@ -416,44 +568,26 @@ static BigNumber ippSBModExp(const BigNumber& base, const BigNumber& exp,
   // R should not be less than the data length of the modulus m
   BigNumber res(mod);
 
-  int mod_bits;
-  Ipp32u* mod_data;
-  ippsRef_BN(nullptr, &mod_bits, &mod_data, BN(mod));
-  int mod_words = BITSIZE_WORD(mod_bits);
-
-  int size;
-  // define and initialize Montgomery Engine over Modulus N
-  stat = ippsMontGetSize(IppsBinaryMethod, mod_words, &size);
-  ERROR_CHECK(stat == ippStsNoErr,
-              "ippMontExp: get the size of IppsMontState context error.");
-
-  auto pMont = std::vector<Ipp8u>(size);
+  int exp_bits;
+  Ipp32u* exp_data;
+  ippsRef_BN(nullptr, &exp_bits, &exp_data, BN(exp));
 
-  stat = ippsMontInit(IppsBinaryMethod, mod_words,
-                      reinterpret_cast<IppsMontState*>(pMont.data()));
-  ERROR_CHECK(stat == ippStsNoErr, "ippMontExp: init Mont context error.");
-
-  stat = ippsMontSet(mod_data, mod_words,
-                     reinterpret_cast<IppsMontState*>(pMont.data()));
-  ERROR_CHECK(stat == ippStsNoErr, "ippMontExp: set Mont input error.");
+  // Montgomery Engine over Modulus N, reused across calls of this thread
+  IppsMontState* pMont = getMontState(mod, getMontExpMethod(exp_bits));
 
   // encode base into Montgomery form
   BigNumber bform(mod);
-  stat = ippsMontForm(BN(base), reinterpret_cast<IppsMontState*>(pMont.data()),
-                      BN(bform));
+  stat = ippsMontForm(BN(base), pMont, BN(bform));
   ERROR_CHECK(stat == ippStsNoErr,
               "ippMontExp: convert big number into Mont form error.");
 
   // compute R = base^pow mod N
-  stat = ippsMontExp(BN(bform), BN(exp),
-                     reinterpret_cast<IppsMontState*>(pMont.data()), BN(res));
+  stat = ippsMontExp(BN(bform), BN(exp), pMont, BN(res));
   ERROR_CHECK(stat == ippStsNoErr,
               std::string("ippsMontExp: error code = ") + std::to_string(stat));
 
-  BigNumber one(1);
   // R = MontMul(R,1)
-  stat = ippsMontMul(BN(res), BN(one),
-                     reinterpret_cast<IppsMontState*>(pMont.data()), BN(res));
+  stat = ippsMontMul(BN(res), BN(BigNumber::One()), pMont, BN(res));
 
   ERROR_CHECK(stat == ippStsNoErr,
               std::string("ippsMontMul: error code = ") + std::to_string(stat));
@@ -461,23 +595,119 @@ static BigNumber ippSBModExp(const BigNumber& base, const BigNumber& exp,
   return res;
 }
 
+// Accelerator backend computing n results into res
+using AcceleratorFn =
+    std::function<void(BNRange, BNRange, BNRange, std::size_t, BigNumber*)>;
+
+static std::shared_ptr<const AcceleratorFn> getDefaultAccelerator() {
+#ifdef IPCL_USE_QAT
+  return std::make_shared<const AcceleratorFn>(
+      [](BNRange base, BNRange exp, BNRange mod, std::size_t n,
+         BigNumber* res) {
+        heQatBnModExp(base, exp, mod, n, IPCL_QAT_MODEXP_BATCH_SIZE, res);
+      });
+#else
+  return nullptr;
+#endif  // IPCL_USE_QAT
+}
+
+static std::mutex g_accelerator_mutex;
+
+static std::shared_ptr<const AcceleratorFn>& getAcceleratorSlot() {
+  static std::shared_ptr<const AcceleratorFn> accel = getDefaultAccelerator();
+  return accel;
+}
+
+static std::shared_ptr<const AcceleratorFn> getAccelerator() {
+  std::lock_guard<std::mutex> lock(g_accelerator_mutex);
+  return getAcceleratorSlot();
+}
+
+void setHybridAccelerator(HybridAccelerator accel) {
+  std::shared_ptr<const AcceleratorFn> fn = getDefaultAccelerator();
+  if (accel) {
+    fn = std::make_shared<const AcceleratorFn>(
+        [accel](BNRange base, BNRange exp, BNRange mod, std::size_t n,
+                BigNumber* res) {
+          std::vector<BigNumber> base_v(n), exp_v(n), mod_v(n);
+          for (std::size_t i = 0; i < n; i++) {
+            base_v[i] = base[i];
+            exp_v[i] = exp[i];
+            mod_v[i] = mod[i];
+          }
+          std::vector<BigNumber> out = accel(base_v, exp_v, mod_v);
+          ERROR_CHECK(out.size() == n,
+                      "HybridAccelerator: output vector size error");
+          std::copy(out.begin(), out.end(), res);
+        });
+  }
+
+  std::lock_guard<std::mutex> lock(g_accelerator_mutex);
+  getAcceleratorSlot() = fn;
+}
+
+bool hasHybridAccelerator() { return getAccelerator() != nullptr; }
+
+HybridAccelerator makeEmulatedAccelerator(
+    std::chrono::microseconds batch_latency,
+    std::chrono::microseconds element_latency) {
+  return [batch_latency, element_latency](const std::vector<BigNumber>& base,
+                                          const std::vector<BigNumber>& exp,
+                                          const std::vector<BigNumber>& mod) {
+    auto deadline = std::chrono::steady_clock::now() + batch_latency +
+                    element_latency * base.size();
+
+    // A single thread, like the request queue of a device
+    std::vector<BigNumber> res(base.size());
+    for (std::size_t i = 0; i < base.size(); i++)
+      res[i] = ippModExp(base[i], exp[i], mod[i]);
+
+    std::this_thread::sleep_until(deadline);
+    return res;
+  };
+}
+
 std::vector<BigNumber> qatModExp(const std::vector<BigNumber>& base,
                                  const std::vector<BigNumber>& exp,
                                  const std::vector<BigNumber>& mod) {
 #ifdef IPCL_USE_QAT
-  return heQatBnModExp(base, exp, mod, IPCL_QAT_MODEXP_BATCH_SIZE);
+  std::vector<BigNumber> res(base.size());
+  heQatBnModExp(toRange(base), toRange(exp), toRange(mod), base.size(),
+                IPCL_QAT_MODEXP_BATCH_SIZE, res.data());
+  return res;
 #else
   ERROR_CHECK(false, "qatModExp: Need to turn on IPCL_ENABLE_QAT");
 #endif  // IPCL_USE_QAT
 }
 
-static std::vector<BigNumber> ippMBModExpWrapper(
-    const std::vector<BigNumber>& base, const std::vector<BigNumber>& exp,
-    const std::vector<BigNumber>& mod) {
-  std::size_t v_size = base.size();
-  std::vector<BigNumber> res(v_size);
+static void ippSBModExpWrapper(BNRange base, BNRange exp, BNRange mod,
+                               std::size_t v_size, BigNumber* res) {
+  if (exp.stride == 0 && mod.stride == 0) {
+    // Recode the shared exponent once and replay the schedule for every base
+    FixedExpModExp engine(exp[0], mod[0]);
 
-  std::size_t remainder = v_size % IPCL_CRYPTO_MB_SIZE;
+#ifdef IPCL_USE_OMP
+    int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
+#endif  // IPCL_USE_OMP
+    for (int i = 0; i < v_size; i++) res[i] = engine.exp(base[i]);
+    return;
+  }
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < v_size; i++)
+    res[i] = ippSBModExp(base[i], exp[i], mod[i]);
+}
+
+static void ippWideMBModExpWrapper(BNRange base, BNRange exp,
+                                   const BigNumber& mod, std::size_t v_size,
+                                   BigNumber* res) {
+  const MBMontContext ctx = createMBMontContext(mod);
   std::size_t num_chunk =
       (v_size + IPCL_CRYPTO_MB_SIZE - 1) / IPCL_CRYPTO_MB_SIZE;
 
@@ -487,130 +717,412 @@ static std::vector<BigNumber> ippMBModExpWrapper(
     OMPUtilities::assignOMPThreads(omp_remaining_threads, num_chunk))
 #endif  // IPCL_USE_OMP
   for (std::size_t i = 0; i < num_chunk; i++) {
-    std::size_t chunk_size = IPCL_CRYPTO_MB_SIZE;
-    if ((i == (num_chunk - 1)) && (remainder > 0)) chunk_size = remainder;
-
     std::size_t chunk_offset = i * IPCL_CRYPTO_MB_SIZE;
+    std::size_t chunk_size =
+        std::min<std::size_t>(IPCL_CRYPTO_MB_SIZE, v_size - chunk_offset);
+    ippWideMBModExp(base + chunk_offset, exp + chunk_offset, mod, ctx,
+                    chunk_size, res + chunk_offset);
+  }
+}
 
-    auto base_start = base.begin() + chunk_offset;
-    auto base_end = base_start + chunk_size;
+static void ippMBModExpWrapper(BNRange base, BNRange exp, BNRange mod,
+                               std::size_t v_size, BigNumber* res) {
+  // Moduli beyond the mbx_exp_mb8 limit (n^2 of 3072 and 4096-bit keys) run
+  // on the wide engine when they are shared by the batch, and single buffer
+  // otherwise
+  int mod_bits = 0;
+  bool shared_mod = true;
+  for (std::size_t i = 0; i < v_size; i++) {
+    mod_bits = std::max(mod_bits, mod[i].BitSize());
+    if (mod.stride != 0 && shared_mod) shared_mod = (mod[i] == mod[0]);
+  }
+  if (mod_bits > IPCL_CRYPTO_MB_MAX_MOD_BITS) {
+    if (shared_mod && mod_bits <= IPCL_MB_MONT_MAX_MOD_BITS)
+      ippWideMBModExpWrapper(base, exp, mod[0], v_size, res);
+    else
+      ippSBModExpWrapper(base, exp, mod, v_size, res);
+    return;
+  }
 
-    auto exp_start = exp.begin() + chunk_offset;
-    auto exp_end = exp_start + chunk_size;
+  std::size_t remainder = v_size % IPCL_CRYPTO_MB_SIZE;
+  std::size_t num_chunk =
+      (v_size + IPCL_CRYPTO_MB_SIZE - 1) / IPCL_CRYPTO_MB_SIZE;
 
-    auto mod_start = mod.begin() + chunk_offset;
-    auto mod_end = mod_start + chunk_size;
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_chunk))
+#endif  // IPCL_USE_OMP
+  for (std::size_t i = 0; i < num_chunk; i++) {
+    std::size_t chunk_size = IPCL_CRYPTO_MB_SIZE;
+    if ((i == (num_chunk - 1)) && (remainder > 0)) chunk_size = remainder;
 
-    auto base_chunk = std::vector<BigNumber>(base_start, base_end);
-    auto exp_chunk = std::vector<BigNumber>(exp_start, exp_end);
-    auto mod_chunk = std::vector<BigNumber>(mod_start, mod_end);
+    std::size_t chunk_offset = i * IPCL_CRYPTO_MB_SIZE;
 
-    auto tmp = ippMBModExp(base_chunk, exp_chunk, mod_chunk);
-    std::copy(tmp.begin(), tmp.end(), res.begin() + chunk_offset);
+    ippMBModExp(base + chunk_offset, exp + chunk_offset, mod + chunk_offset,
+                chunk_size, res + chunk_offset);
   }
+}
 
-  return res;
+// Check whether batches run on the multi-buffer (AVX512-IFMA) kernel
+static bool useMBModExp() {
+#ifdef IPCL_RUNTIME_DETECT_CPU_FEATURES
+  return has_avx512ifma;
+#elif IPCL_CRYPTO_MB_MOD_EXP
+  return true;
+#else
+  return false;
+#endif  // IPCL_RUNTIME_DETECT_CPU_FEATURES
 }
 
-static std::vector<BigNumber> ippSBModExpWrapper(
-    const std::vector<BigNumber>& base, const std::vector<BigNumber>& exp,
-    const std::vector<BigNumber>& mod) {
-  std::size_t v_size = base.size();
-  std::vector<BigNumber> res(v_size);
+// Compute v_size results into res, reading the operands in place
+static void ippModExpRange(BNRange base, BNRange exp, BNRange mod,
+                           std::size_t v_size, BigNumber* res) {
+  // If there is only 1 big number, we don't need to use MBModExp
+  if (v_size == 1) {
+    res[0] = ippSBModExp(base[0], exp[0], mod[0]);
+    return;
+  }
 
-#ifdef IPCL_USE_OMP
-  int omp_remaining_threads = OMPUtilities::MaxThreads;
-#pragma omp parallel for num_threads( \
-    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
-#endif  // IPCL_USE_OMP
-  for (int i = 0; i < v_size; i++)
-    res[i] = ippSBModExp(base[i], exp[i], mod[i]);
+  if (useMBModExp())
+    ippMBModExpWrapper(base, exp, mod, v_size, res);
+  else
+    ippSBModExpWrapper(base, exp, mod, v_size, res);
+}
 
+std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
+                                 const std::vector<BigNumber>& exp,
+                                 const std::vector<BigNumber>& mod) {
+  std::vector<BigNumber> res(base.size());
+  ippModExpRange(toRange(base), toRange(exp), toRange(mod), base.size(),
+                 res.data());
   return res;
 }
 
 std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
                                  const std::vector<BigNumber>& exp,
-                                 const std::vector<BigNumber>& mod) {
-  std::size_t v_size = base.size();
+                                 const BigNumber& mod) {
+  ERROR_CHECK(base.size() == exp.size(), "ippModExp: input vector size error");
+  std::vector<BigNumber> res(base.size());
+  ippModExpRange(toRange(base), toRange(exp), toRange(mod), base.size(),
+                 res.data());
+  return res;
+}
+
+std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
+                                 const BigNumber& exp, const BigNumber& mod) {
+  std::vector<BigNumber> res(base.size());
+  ippModExpRange(toRange(base), toRange(exp), toRange(mod), base.size(),
+                 res.data());
+  return res;
+}
+
+// Dispatch the batch to the accelerator, IPP or both according to the hybrid
+// settings
+static std::vector<BigNumber> modExpRange(BNRange base, BNRange exp,
+                                          BNRange mod, std::size_t v_size) {
   std::vector<BigNumber> res(v_size);
 
-  // If there is only 1 big number, we don't need to use MBModExp
-  if (v_size == 1) {
-    res[0] = ippSBModExp(base[0], exp[0], mod[0]);
+  std::shared_ptr<const AcceleratorFn> accel = getAccelerator();
+  if (!accel) {
+    ippModExpRange(base, exp, mod, v_size, res.data());
     return res;
   }
 
-#ifdef IPCL_RUNTIME_DETECT_CPU_FEATURES
-  if (has_avx512ifma) {
-    return ippMBModExpWrapper(base, exp, mod);
+// if QAT is ON, OMP is OFF --> use QAT only
+#if defined(IPCL_USE_QAT) && !defined(IPCL_USE_OMP)
+  (*accel)(base, exp, mod, v_size, res.data());
+#else
+  bool adaptive = isHybridAdaptive();
+  HybridOp op = g_hybrid_params.op;
+
+  std::size_t hybrid_accel_size;
+  if (adaptive) {
+    hybrid_accel_size =
+        HybridController::getInstance().getAcceleratorShare(op, v_size);
   } else {
-    return ippSBModExpWrapper(base, exp, mod);
+    ERROR_CHECK(g_hybrid_params.ratio >= 0.0 && g_hybrid_params.ratio <= 1.0,
+                "modExp: hybrid modexp qat ratio is incorrect");
+    hybrid_accel_size =
+        static_cast<std::size_t>(g_hybrid_params.ratio * v_size);
   }
-#elif IPCL_CRYPTO_MB_MOD_EXP
-  return ippMBModExpWrapper(base, exp, mod);
-#else
-  return ippSBModExpWrapper(base, exp, mod);
-#endif  // IPCL_RUNTIME_DETECT_CPU_FEATURES
+
+  if (hybrid_accel_size == v_size) {
+    // use the accelerator only
+    (*accel)(base, exp, mod, v_size, res.data());
+  } else if (hybrid_accel_size == 0) {
+    // use IPP only
+    ippModExpRange(base, exp, mod, v_size, res.data());
+  } else {
+    // use the accelerator & IPP together: the accelerator share runs on a
+    // persistent worker while this thread runs the IPP share, both write
+    // into res in place
+    using Clock = std::chrono::steady_clock;
+    double accel_seconds = 0.0;
+    std::future<void> accel_done = getHybridExecutor().submit([&] {
+      auto start = Clock::now();
+      (*accel)(base, exp, mod, hybrid_accel_size, res.data());
+      accel_seconds =
+          std::chrono::duration<double>(Clock::now() - start).count();
+    });
+
+    auto start = Clock::now();
+    try {
+      ippModExpRange(base + hybrid_accel_size, exp + hybrid_accel_size,
+                     mod + hybrid_accel_size, v_size - hybrid_accel_size,
+                     res.data() + hybrid_accel_size);
+    } catch (...) {
+      accel_done.wait();  // the accelerator share still refers to res
+      throw;
+    }
+    double cpu_seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    accel_done.get();
+
+    if (adaptive) {
+      HybridController::getInstance().update(
+          op, v_size, hybrid_accel_size, accel_seconds, cpu_seconds);
+    }
+  }
+#endif  // IPCL_USE_QAT && !IPCL_USE_OMP
+  return res;
 }
 
 std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
                               const std::vector<BigNumber>& exp,
                               const std::vector<BigNumber>& mod) {
-#ifdef IPCL_USE_QAT
-// if QAT is ON, OMP is OFF --> use QAT only
-#if !defined(IPCL_USE_OMP)
-  return qatModExp(base, exp, mod);
-#else
-  ERROR_CHECK(g_hybrid_params.ratio >= 0.0 && g_hybrid_params.ratio <= 1.0,
-              "modExp: hybrid modexp qat ratio is incorrect");
-  std::size_t v_size = base.size();
-  std::size_t hybrid_qat_size =
-      static_cast<std::size_t>(g_hybrid_params.ratio * v_size);
+  return modExpRange(toRange(base), toRange(exp), toRange(mod), base.size());
+}
 
-  if (hybrid_qat_size == v_size) {
-    // use QAT only
-    return qatModExp(base, exp, mod);
-  } else if (hybrid_qat_size == 0) {
-    // use IPP only
-    return ippModExp(base, exp, mod);
-  } else {
-    // use QAT & IPP together
-    std::vector<BigNumber> res(v_size);
+std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
+                              const std::vector<BigNumber>& exp,
+                              const BigNumber& mod) {
+  ERROR_CHECK(base.size() == exp.size(), "modExp: input vector size error");
+  return modExpRange(toRange(base), toRange(exp), toRange(mod), base.size());
+}
 
-    auto qat_base_start = base.begin();
-    auto qat_base_end = qat_base_start + hybrid_qat_size;
+std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
+                              const BigNumber& exp, const BigNumber& mod) {
+  return modExpRange(toRange(base), toRange(exp), toRange(mod), base.size());
+}
 
-    auto qat_exp_start = exp.begin();
-    auto qat_exp_end = qat_exp_start + hybrid_qat_size;
+// Compute both halves of a CRT batch on the multi-buffer kernel. The full
+// chunks of a half read its shared pow and modulus in place, and the tails of
+// the two halves share one chunk when they fit in it, so that a single
+// element takes one 2-lane call.
+static void ippMBModExpCRT(std::vector<BigNumber>& res_p,
+                           std::vector<BigNumber>& res_q,
+                           const std::vector<BigNumber>& base_p,
+                           const BigNumber& exp_p, const BigNumber& mod_p,
+                           const std::vector<BigNumber>& base_q,
+                           const BigNumber& exp_q, const BigNumber& mod_q) {
+  struct Chunk {
+    BNRange base, exp, mod;
+    std::size_t size;
+    BigNumber* res;
+  };
+
+  std::size_t p_size = base_p.size();
+  std::size_t q_size = base_q.size();
+  std::size_t p_tail = p_size % IPCL_CRYPTO_MB_SIZE;
+  std::size_t q_tail = q_size % IPCL_CRYPTO_MB_SIZE;
+  bool merge_tails = p_tail + q_tail <= IPCL_CRYPTO_MB_SIZE;
+
+  std::vector<Chunk> chunks;
+  for (std::size_t i = 0; i < p_size; i += IPCL_CRYPTO_MB_SIZE) {
+    std::size_t size = std::min<std::size_t>(IPCL_CRYPTO_MB_SIZE, p_size - i);
+    if (size < IPCL_CRYPTO_MB_SIZE && merge_tails) break;
+    chunks.push_back({toRange(base_p) + i, toRange(exp_p), toRange(mod_p),
+                      size, res_p.data() + i});
+  }
+  for (std::size_t i = 0; i < q_size; i += IPCL_CRYPTO_MB_SIZE) {
+    std::size_t size = std::min<std::size_t>(IPCL_CRYPTO_MB_SIZE, q_size - i);
+    if (size < IPCL_CRYPTO_MB_SIZE && merge_tails) break;
+    chunks.push_back({toRange(base_q) + i, toRange(exp_q), toRange(mod_q),
+                      size, res_q.data() + i});
+  }
 
-    auto qat_mod_start = mod.begin();
-    auto qat_mod_end = qat_mod_start + hybrid_qat_size;
+  // the merged tail only copies its own operands
+  std::array<BigNumber, IPCL_CRYPTO_MB_SIZE> tail_base, tail_exp, tail_mod,
+      tail_res;
+  std::size_t tail_size = merge_tails ? p_tail + q_tail : 0;
+  if (tail_size > 0) {
+    for (std::size_t i = 0; i < p_tail; i++) {
+      tail_base[i] = base_p[p_size - p_tail + i];
+      tail_exp[i] = exp_p;
+      tail_mod[i] = mod_p;
+    }
+    for (std::size_t i = 0; i < q_tail; i++) {
+      tail_base[p_tail + i] = base_q[q_size - q_tail + i];
+      tail_exp[p_tail + i] = exp_q;
+      tail_mod[p_tail + i] = mod_q;
+    }
+    chunks.push_back({{tail_base.data(), 1},
+                      {tail_exp.data(), 1},
+                      {tail_mod.data(), 1},
+                      tail_size,
+                      tail_res.data()});
+  }
 
-    auto qat_base = std::vector<BigNumber>(qat_base_start, qat_base_end);
-    auto qat_exp = std::vector<BigNumber>(qat_exp_start, qat_exp_end);
-    auto qat_mod = std::vector<BigNumber>(qat_mod_start, qat_mod_end);
+  std::size_t num_chunk = chunks.size();
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_chunk))
+#endif  // IPCL_USE_OMP
+  for (std::size_t i = 0; i < num_chunk; i++) {
+    const Chunk& c = chunks[i];
+    ippMBModExp(c.base, c.exp, c.mod, c.size, c.res);
+  }
 
-    auto ipp_base = std::vector<BigNumber>(qat_base_end, base.end());
-    auto ipp_exp = std::vector<BigNumber>(qat_exp_end, exp.end());
-    auto ipp_mod = std::vector<BigNumber>(qat_mod_end, mod.end());
+  for (std::size_t i = 0; i < p_tail && tail_size > 0; i++)
+    res_p[p_size - p_tail + i] = std::move(tail_res[i]);
+  for (std::size_t i = 0; i < q_tail && tail_size > 0; i++)
+    res_q[q_size - q_tail + i] = std::move(tail_res[p_tail + i]);
+}
 
-    std::vector<BigNumber> qat_res, ipp_res;
-    std::thread qat_thread([&] {
-      qat_res = qatModExp(qat_base, qat_exp, qat_mod);
-      std::copy(qat_res.begin(), qat_res.end(), res.begin());
-    });
+void modExpCRT(std::vector<BigNumber>& res_p, std::vector<BigNumber>& res_q,
+               const std::vector<BigNumber>& base_p, const BigNumber& exp_p,
+               const BigNumber& mod_p, const std::vector<BigNumber>& base_q,
+               const BigNumber& exp_q, const BigNumber& mod_q) {
+  ERROR_CHECK(!base_p.empty() && !base_q.empty(),
+              "modExpCRT: input vector size error");
+
+  // Each half is a batch with a shared pow and modulus, unless both can
+  // share the lanes of the multi-buffer kernel
+  int mod_bits = std::max(mod_p.BitSize(), mod_q.BitSize());
+  if (getAccelerator() || !useMBModExp() ||
+      mod_bits > IPCL_CRYPTO_MB_MAX_MOD_BITS) {
+    res_p = modExp(base_p, exp_p, mod_p);
+    res_q = modExp(base_q, exp_q, mod_q);
+    return;
+  }
 
-    ipp_res = ippModExp(ipp_base, ipp_exp, ipp_mod);
-    std::copy(ipp_res.begin(), ipp_res.end(), res.begin() + hybrid_qat_size);
+  res_p.resize(base_p.size());
+  res_q.resize(base_q.size());
+  ippMBModExpCRT(res_p, res_q, base_p, exp_p, mod_p, base_q, exp_q, mod_q);
+}
 
-    qat_thread.join();
-    return res;
+static int getBitLength(const int64u* limbs, std::size_t n) {
+  for (std::size_t i = n; i > 0; i--)
+    if (limbs[i - 1]) return (i - 1) * 64 + 64 - __builtin_clzll(limbs[i - 1]);
+  return 0;
+}
+
+// Compute up to IPCL_CRYPTO_MB_SIZE packed results starting at offset, the
+// lanes point straight into the packed buffers. A packed exp of size 1 is
+// shared by all the bases.
+static void ippMBModExpPacked(const PackedBigNumbers& base,
+                              const PackedBigNumbers& exp,
+                              const PackedBigNumbers& mod, std::size_t offset,
+                              std::size_t real_v_size, PackedBigNumbers* res) {
+  ERROR_CHECK(real_v_size > 0 && real_v_size <= IPCL_CRYPTO_MB_SIZE,
+              "ippMBModExpPacked: input vector size error");
+
+  int mod_bits = mod.getBits();
+  int mod_dwords = BITSIZE_DWORD(mod_bits);
+  int work_buff_size = mbx_exp_BufferSize(mod_bits);
+
+  MBModExpWorkspace& ws = g_mb_workspace;
+  ws.reserve(mod_dwords, work_buff_size);
+
+  // Idle lanes compute 0^0 in the workspace
+  std::memset(ws.base_buff.data(), 0, mod_dwords * sizeof(int64u));
+  std::memset(ws.exp_buff.data(), 0, mod_dwords * sizeof(int64u));
+
+  std::array<int64u*, IPCL_CRYPTO_MB_SIZE> out_pa;
+  std::array<const int64u*, IPCL_CRYPTO_MB_SIZE> base_pa;
+  std::array<const int64u*, IPCL_CRYPTO_MB_SIZE> exp_pa;
+  std::array<const int64u*, IPCL_CRYPTO_MB_SIZE> mod_pa;
+
+  int exp_bits = 1;
+  for (int i = 0; i < IPCL_CRYPTO_MB_SIZE; i++) {
+    mod_pa[i] = mod.data(0);
+    if (i < real_v_size) {
+      out_pa[i] = res->data(offset + i);
+      base_pa[i] = base.data(offset + i);
+      exp_pa[i] = exp.data(exp.size() == 1 ? 0 : offset + i);
+      exp_bits =
+          std::max(exp_bits, getBitLength(exp_pa[i], exp.getStride()));
+    } else {
+      out_pa[i] = ws.out_buff.data();
+      base_pa[i] = ws.base_buff.data();
+      exp_pa[i] = ws.exp_buff.data();
+    }
   }
+
+  mbx_status st =
+      mbx_exp_mb8(out_pa.data(), base_pa.data(), exp_pa.data(), exp_bits,
+                  mod_pa.data(), mod_bits, ws.work_buff.data(), work_buff_size);
+
+  for (int i = 0; i < real_v_size; i++) {
+    ERROR_CHECK(MBX_STATUS_OK == MBX_GET_STS(st, i),
+                std::string("ippMultiBuffExp: error multi buffered exp "
+                            "modules, error code = ") +
+                    std::to_string(MBX_GET_STS(st, i)));
+  }
+}
+
+PackedBigNumbers modExp(const PackedBigNumbers& base,
+                        const PackedBigNumbers& exp, const BigNumber& mod) {
+  ERROR_CHECK(exp.size() == base.size() || exp.size() == 1,
+              "modExp: input vector size error");
+
+  std::size_t v_size = base.size();
+  PackedBigNumbers packed_mod(std::vector<BigNumber>{mod});
+  int mod_bits = packed_mod.getBits();
+
+  // the idle lanes read their pow from a workspace of the modulus width
+  ERROR_CHECK(exp.getBits() <= mod_bits,
+              "modExp: packed pows are wider than the modulus");
+
+  // The single buffer, single element, accelerator and wide modulus paths
+  // work on BigNumber
+  if (!useMBModExp() || v_size <= 1 || hasHybridAccelerator() ||
+      mod_bits > IPCL_CRYPTO_MB_MAX_MOD_BITS) {
+    std::vector<BigNumber> res = (exp.size() == 1)
+                                     ? modExp(base.unpack(), exp.get(0), mod)
+                                     : modExp(base.unpack(), exp.unpack(), mod);
+    return PackedBigNumbers(res, mod_bits);
+  }
+
+  ERROR_CHECK(base.getStride() >= BITSIZE_DWORD(mod_bits),
+              "modExp: packed bases are narrower than the modulus");
+
+  PackedBigNumbers res(v_size, mod_bits);
+  std::size_t num_chunk =
+      (v_size + IPCL_CRYPTO_MB_SIZE - 1) / IPCL_CRYPTO_MB_SIZE;
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_chunk))
 #endif  // IPCL_USE_OMP
-#else
-  return ippModExp(base, exp, mod);
-#endif  // IPCL_USE_QAT
+  for (std::size_t i = 0; i < num_chunk; i++) {
+    std::size_t chunk_offset = i * IPCL_CRYPTO_MB_SIZE;
+    std::size_t chunk_size =
+        std::min<std::size_t>(IPCL_CRYPTO_MB_SIZE, v_size - chunk_offset);
+    ippMBModExpPacked(base, exp, packed_mod, chunk_offset, chunk_size, &res);
+  }
+
+  return res;
+}
+
+PackedBigNumbers modExp(const PackedBigNumbers& base, const BigNumber& exp,
+                        const BigNumber& mod) {
+  return modExp(base, PackedBigNumbers(std::vector<BigNumber>{exp}), mod);
+}
+
+std::future<std::vector<BigNumber>> modExpAsync(std::vector<BigNumber> base,
+                                                std::vector<BigNumber> exp,
+                                                std::vector<BigNumber> mod) {
+  HybridParams params = getHybridParams();
+  return Executor::getDefault().submit(
+      [params, base = std::move(base), exp = std::move(exp),
+       mod = std::move(mod)] {
+        setHybridParams(params);
+        return modExp(base, exp, mod);
+      });
 }
 
 BigNumber modExp(const BigNumber& base, const BigNumber& exp,
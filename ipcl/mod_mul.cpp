@@ -0,0 +1,178 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/mod_mul.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ipcl/utils/mb_mont.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+// Check whether batches run on the multi-buffer (AVX512-IFMA) kernel
+static bool useMBModMul() {
+#ifdef IPCL_RUNTIME_DETECT_CPU_FEATURES
+  return has_avx512ifma;
+#elif IPCL_CRYPTO_MB_MOD_EXP
+  return true;
+#else
+  return false;
+#endif  // IPCL_RUNTIME_DETECT_CPU_FEATURES
+}
+
+namespace {
+
+// Per-thread lanes of the multi-buffer multiplication, grown on demand and
+// reused by every 8-lane group of the thread. The a lanes and the
+// accumulators hold double-width operands for the Montgomery reduction.
+struct MBModMulWorkspace {
+  MBDigits a_lanes;
+  MBDigits b_lanes;
+  MBDigits t_lanes;
+  MBDigits acc;
+
+  void reserve(std::size_t lanes_size) {
+    if (b_lanes.size() < lanes_size) {
+      a_lanes.resize(2 * lanes_size);
+      b_lanes.resize(lanes_size);
+      t_lanes.resize(lanes_size);
+      acc.resize(2 * lanes_size + IPCL_CRYPTO_MB_SIZE);
+    }
+  }
+};
+
+thread_local MBModMulWorkspace g_mb_mul_workspace;
+
+}  // namespace
+
+static std::vector<BigNumber> ippMBModMul(const std::vector<BigNumber>& a,
+                                          const std::vector<BigNumber>& b,
+                                          const BigNumber& mod) {
+  std::size_t v_size = a.size();
+  bool b_scalar = (b.size() == 1);
+
+  const MBMontContext ctx = createMBMontContext(mod);
+  const int n = ctx.digits;
+  const int mod_bits = mod.BitSize();
+  const std::size_t lanes_size = n * IPCL_CRYPTO_MB_SIZE;
+
+  // Groups with an a not less than the modulus, e.g. ciphertexts mod n^2
+  // multiplied mod n, start with a Montgomery reduction of the double-width
+  // a instead of a division: t = a * R^-1.
+  // A scalar b is converted once into bR for the reduced a and bR^2 for t,
+  // so that every product takes one Montgomery multiplication:
+  // a * bR * R^-1 = t * bR^2 * R^-1 = a * b. A vector b is restored with
+  // R^2 after a * b * R^-1, or with R^3 after t * b * R^-1.
+  MBModMulWorkspace& setup = g_mb_mul_workspace;
+  setup.reserve(lanes_size);
+  MBDigits b_mont, b_mont2, rrr;
+  if (b_scalar) {
+    for (int lane = 0; lane < IPCL_CRYPTO_MB_SIZE; lane++)
+      toMBLane(b[0], mod, n, setup.b_lanes.data() + lane);
+    b_mont.resize(lanes_size);
+    b_mont2.resize(lanes_size);
+    mbMontMul(b_mont.data(), setup.b_lanes.data(), ctx.rr.data(), ctx,
+              setup.acc.data());
+    mbMontMul(b_mont2.data(), b_mont.data(), ctx.rr.data(), ctx,
+              setup.acc.data());
+  } else {
+    rrr.resize(lanes_size);
+    mbMontMul(rrr.data(), ctx.rr.data(), ctx.rr.data(), ctx, setup.acc.data());
+  }
+
+  std::vector<BigNumber> res(v_size);
+  std::size_t num_groups =
+      (v_size + IPCL_CRYPTO_MB_SIZE - 1) / IPCL_CRYPTO_MB_SIZE;
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_groups))
+#endif  // IPCL_USE_OMP
+  for (int g = 0; g < num_groups; g++) {
+    std::size_t begin = g * IPCL_CRYPTO_MB_SIZE;
+    int lanes = std::min<std::size_t>(IPCL_CRYPTO_MB_SIZE, v_size - begin);
+
+    MBModMulWorkspace& ws = g_mb_mul_workspace;
+    ws.reserve(lanes_size);
+    Ipp64u* a_lanes = ws.a_lanes.data();
+    Ipp64u* b_lanes = ws.b_lanes.data();
+    Ipp64u* t_lanes = ws.t_lanes.data();
+
+    // longer than the modulus, which the exact comparison would only refine
+    bool wide = false;
+    for (int lane = 0; lane < lanes; lane++) {
+      int bits;
+      ippsRef_BN(nullptr, &bits, nullptr, BN(a[begin + lane]));
+      wide = wide || bits > mod_bits;
+    }
+
+    // idle lanes multiply zeros
+    if (lanes < IPCL_CRYPTO_MB_SIZE) {
+      std::memset(a_lanes, 0, (wide ? 2 : 1) * lanes_size * sizeof(Ipp64u));
+      std::memset(b_lanes, 0, lanes_size * sizeof(Ipp64u));
+    }
+    if (wide) {
+      for (int lane = 0; lane < lanes; lane++)
+        toMBLaneWide(a[begin + lane], mod, n, a_lanes + lane);
+      mbMontRedc(a_lanes, a_lanes, ctx, ws.acc.data());
+    } else {
+      for (int lane = 0; lane < lanes; lane++)
+        toMBLane(a[begin + lane], mod, n, a_lanes + lane);
+    }
+
+    if (b_scalar) {
+      const MBDigits& bm = wide ? b_mont2 : b_mont;
+      mbMontMul(t_lanes, a_lanes, bm.data(), ctx, ws.acc.data());
+    } else {
+      for (int lane = 0; lane < lanes; lane++)
+        toMBLane(b[begin + lane], mod, n, b_lanes + lane);
+      const MBDigits& rn = wide ? rrr : ctx.rr;
+      mbMontMul(t_lanes, a_lanes, b_lanes, ctx, ws.acc.data());
+      mbMontMul(t_lanes, t_lanes, rn.data(), ctx, ws.acc.data());
+    }
+
+    for (int lane = 0; lane < lanes; lane++)
+      res[begin + lane] = fromMBLane(t_lanes + lane, n);
+  }
+  return res;
+}
+
+static std::vector<BigNumber> ippSBModMul(const std::vector<BigNumber>& a,
+                                          const std::vector<BigNumber>& b,
+                                          const BigNumber& mod) {
+  std::size_t v_size = a.size();
+  bool b_scalar = (b.size() == 1);
+  std::vector<BigNumber> res(v_size);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < v_size; i++) {
+    // Hold a copy of the modulus for multi-threaded
+    const BigNumber m = mod;
+    res[i] = a[i] * b[b_scalar ? 0 : i] % m;
+  }
+  return res;
+}
+
+std::vector<BigNumber> modMul(const std::vector<BigNumber>& a,
+                              const std::vector<BigNumber>& b,
+                              const BigNumber& mod) {
+  std::size_t v_size = a.size();
+  ERROR_CHECK(v_size > 0 && (b.size() == v_size || b.size() == 1),
+              "modMul: input vector size error");
+  ERROR_CHECK(mod.IsOdd(), "modMul: modulus should be odd");
+
+  // the Montgomery constants only pay off for a full batch
+  if (useMBModMul() && v_size >= IPCL_CRYPTO_MB_SIZE &&
+      mod.BitSize() <= IPCL_MB_MONT_MAX_MOD_BITS)
+    return ippMBModMul(a, b, mod);
+  return ippSBModMul(a, b, mod);
+}
+
+}  // namespace ipcl
@@ -0,0 +1,130 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/mod_prod.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "ipcl/mod_exp.hpp"
+#include "ipcl/utils/mont_cache.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+// Product of v[begin, end) times R^-(end - begin - 1), as every Montgomery
+// multiplication of two plain elements introduces one factor R^-1. An empty
+// range yields R mod m, which is neutral for the Montgomery multiplication.
+static BigNumber montProd(const std::vector<BigNumber>& v, std::size_t begin,
+                          std::size_t end, const BigNumber& mod) {
+  if (begin == end) return toMontForm(BigNumber::One(), mod);
+
+  IppsMontState* pMont = getMontState(mod);
+  BigNumber acc(mod);
+  acc = v[begin];
+  for (std::size_t i = begin + 1; i < end; i++) {
+    IppStatus stat = ippsMontMul(BN(acc), BN(v[i]), pMont, BN(acc));
+    ERROR_CHECK(stat == ippStsNoErr, std::string("ippsMontMul: error code = ") +
+                                         std::to_string(stat));
+  }
+  return acc;
+}
+
+std::vector<BigNumber> modProd(const std::vector<BigNumber>& v,
+                               std::size_t block_size, const BigNumber& mod,
+                               bool mont_form) {
+  std::size_t v_size = v.size();
+  ERROR_CHECK(v_size > 0, "modProd: input vector is empty");
+  ERROR_CHECK(block_size > 0, "modProd: block size should be positive");
+  ERROR_CHECK(mod.IsOdd(), "modProd: modulus should be odd");
+
+  block_size = std::min(block_size, v_size);
+  std::size_t num_blocks = (v_size + block_size - 1) / block_size;
+
+  // split the blocks into parts until every thread has work
+  std::size_t num_parts = 1;
+#ifdef IPCL_USE_OMP
+  std::size_t max_threads = OMPUtilities::MaxThreads;
+  if (num_blocks < max_threads) {
+    num_parts = (max_threads + num_blocks - 1) / num_blocks;
+    num_parts = std::min(num_parts, block_size / IPCL_MOD_PROD_MIN_PART_SIZE);
+    num_parts = std::max<std::size_t>(num_parts, 1);
+  }
+#endif  // IPCL_USE_OMP
+
+  std::size_t num_tasks = num_blocks * num_parts;
+  std::vector<BigNumber> partial(num_tasks);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_tasks))
+#endif  // IPCL_USE_OMP
+  for (int t = 0; t < num_tasks; t++) {
+    std::size_t block = t / num_parts, part = t % num_parts;
+    std::size_t block_begin = block * block_size;
+    std::size_t len = std::min(block_size, v_size - block_begin);
+    partial[t] = montProd(v, block_begin + len * part / num_parts,
+                          block_begin + len * (part + 1) / num_parts, mod);
+  }
+
+  // tree reduction of the parts of each block, a block of len elements
+  // ends up scaled by R^-(len - 1) whatever its split into parts
+  for (std::size_t stride = 1; stride < num_parts; stride *= 2) {
+    std::size_t block_pairs = (num_parts + 2 * stride - 1) / (2 * stride);
+    std::size_t num_pairs = num_blocks * block_pairs;
+#ifdef IPCL_USE_OMP
+    omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_pairs))
+#endif  // IPCL_USE_OMP
+    for (int j = 0; j < num_pairs; j++) {
+      std::size_t block = j / block_pairs;
+      std::size_t part = j % block_pairs * 2 * stride;
+      if (part + stride >= num_parts) continue;
+      std::size_t t = block * num_parts + part;
+
+      IppsMontState* pMont = getMontState(mod);
+      IppStatus stat = ippsMontMul(BN(partial[t]), BN(partial[t + stride]),
+                                   pMont, BN(partial[t]));
+      ERROR_CHECK(stat == ippStsNoErr,
+                  std::string("ippsMontMul: error code = ") +
+                      std::to_string(stat));
+    }
+  }
+
+  // the product of len Montgomery form elements aR is P * R^len * R^-(len - 1)
+  // = P * R, which is already the Montgomery form of the product
+  if (mont_form) {
+    std::vector<BigNumber> res(num_blocks);
+    for (std::size_t j = 0; j < num_blocks; j++)
+      res[j] = std::move(partial[j * num_parts]);
+    return res;
+  }
+
+  // otherwise remove the R^-(len - 1) factor with one Montgomery
+  // multiplication by R^len mod m, which only differs for the last block
+  BigNumber mont_one = toMontForm(BigNumber::One(), mod);
+  std::size_t last_size = v_size - (num_blocks - 1) * block_size;
+  BigNumber block_scale =
+      modExp(mont_one, BigNumber(static_cast<Ipp32u>(block_size)), mod);
+  BigNumber last_scale =
+      (last_size == block_size)
+          ? block_scale
+          : modExp(mont_one, BigNumber(static_cast<Ipp32u>(last_size)), mod);
+
+  std::vector<BigNumber> res(num_blocks);
+#ifdef IPCL_USE_OMP
+  omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_blocks))
+#endif  // IPCL_USE_OMP
+  for (int j = 0; j < num_blocks; j++) {
+    const BigNumber& scale = (j + 1 < num_blocks) ? block_scale : last_scale;
+    res[j] = montMul(partial[j * num_parts], scale, mod);
+  }
+  return res;
+}
+
+}  // namespace ipcl
@@ -0,0 +1,171 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/multi_exp.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "ipcl/utils/mont_cache.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+constexpr int MULTI_EXP_WINDOW_MAX = 16;
+
+// Pick the window size minimizing the number of multiplications of the
+// bucket method: per window one per base and two per bucket, plus the
+// squarings of the accumulator.
+static int chooseWindowBits(std::size_t n, int exp_bits) {
+  int best_w = 1;
+  double best_cost = 0.0;
+  for (int w = 1; w <= MULTI_EXP_WINDOW_MAX; w++) {
+    int n_windows = (exp_bits + w - 1) / w;
+    double cost = n_windows * (static_cast<double>(n) + 2.0 * (1 << w));
+    if (w == 1 || cost < best_cost) {
+      best_cost = cost;
+      best_w = w;
+    }
+  }
+  return best_w;
+}
+
+static int getWindowDigit(const Ipp32u* data, int words, int bit_pos,
+                          int w) {
+  int idx = bit_pos >> 5;
+  if (idx >= words) return 0;
+  int shift = bit_pos & 31;
+  Ipp64u digit = data[idx] >> shift;
+  if ((shift + w > 32) && (idx + 1 < words))
+    digit |= static_cast<Ipp64u>(data[idx + 1]) << (32 - shift);
+  return static_cast<int>(digit & ((1u << w) - 1));
+}
+
+static void montMul(const BigNumber& a, const BigNumber& b,
+                    IppsMontState* pMont, BigNumber& r) {
+  IppStatus stat = ippsMontMul(BN(a), BN(b), pMont, BN(r));
+  ERROR_CHECK(stat == ippStsNoErr,
+              std::string("ippsMontMul: error code = ") + std::to_string(stat));
+}
+
+// Bucket method over n bases, the empty buckets and accumulators are
+// tracked so that multiplications by one are skipped
+static BigNumber multiExpPart(const BigNumber* base, const BigNumber* exp,
+                              std::size_t n, const BigNumber& mod,
+                              int exp_bits, int w) {
+  IppsMontState* pMont = getMontState(mod);
+
+  std::vector<BigNumber> mont_base(n, mod);
+  std::vector<Ipp32u*> exp_data(n);
+  std::vector<int> exp_words(n);
+  for (std::size_t i = 0; i < n; i++) {
+    IppStatus stat = ippsMontForm(BN(base[i]), pMont, BN(mont_base[i]));
+    ERROR_CHECK(stat == ippStsNoErr,
+                "multiExp: convert big number into Mont form error.");
+
+    IppsBigNumSGN sgn;
+    int bits;
+    ippsRef_BN(&sgn, &bits, &exp_data[i], BN(exp[i]));
+    ERROR_CHECK(sgn == IppsBigNumPOS, "multiExp: pow should be non-negative");
+    exp_words[i] = BITSIZE_WORD(bits);
+  }
+
+  std::size_t num_buckets = (1u << w) - 1;
+  std::vector<BigNumber> bucket(num_buckets, mod);
+  std::vector<bool> bucket_used(num_buckets);
+  BigNumber acc(mod), sum(mod), total(mod);
+  bool acc_used = false;
+
+  int n_windows = (exp_bits + w - 1) / w;
+  for (int k = n_windows - 1; k >= 0; k--) {
+    if (acc_used)
+      for (int j = 0; j < w; j++) montMul(acc, acc, pMont, acc);
+
+    std::fill(bucket_used.begin(), bucket_used.end(), false);
+    for (std::size_t i = 0; i < n; i++) {
+      int d = getWindowDigit(exp_data[i], exp_words[i], k * w, w);
+      if (d == 0) continue;
+      if (bucket_used[d - 1]) {
+        montMul(bucket[d - 1], mont_base[i], pMont, bucket[d - 1]);
+      } else {
+        bucket[d - 1] = mont_base[i];
+        bucket_used[d - 1] = true;
+      }
+    }
+
+    // total = prod(bucket[d]^d), as the product of the running products
+    // taken from the highest digit down
+    bool sum_used = false, total_used = false;
+    for (std::size_t d = num_buckets; d > 0; d--) {
+      if (bucket_used[d - 1]) {
+        if (sum_used) {
+          montMul(sum, bucket[d - 1], pMont, sum);
+        } else {
+          sum = bucket[d - 1];
+          sum_used = true;
+        }
+      }
+      if (!sum_used) continue;
+      if (total_used) {
+        montMul(total, sum, pMont, total);
+      } else {
+        total = sum;
+        total_used = true;
+      }
+    }
+
+    if (!total_used) continue;
+    if (acc_used) {
+      montMul(acc, total, pMont, acc);
+    } else {
+      acc = total;
+      acc_used = true;
+    }
+  }
+
+  if (!acc_used) return BigNumber::One();
+
+  // convert out of Montgomery form
+  BigNumber res(mod);
+  montMul(acc, BigNumber::One(), pMont, res);
+  return res;
+}
+
+BigNumber multiExp(const std::vector<BigNumber>& base,
+                   const std::vector<BigNumber>& exp, const BigNumber& mod) {
+  std::size_t n = base.size();
+  ERROR_CHECK(n > 0 && n == exp.size(), "multiExp: input vector size error");
+  ERROR_CHECK(mod.IsOdd(), "multiExp: modulus should be odd");
+
+  int exp_bits = 1;
+  for (const auto& e : exp) exp_bits = std::max(exp_bits, e.BitSize());
+
+  std::size_t num_parts = 1;
+#ifdef IPCL_USE_OMP
+  num_parts = std::min<std::size_t>(OMPUtilities::MaxThreads,
+                                    n / IPCL_MULTI_EXP_MIN_PART_SIZE);
+  num_parts = std::max<std::size_t>(num_parts, 1);
+#endif  // IPCL_USE_OMP
+
+  int w = chooseWindowBits((n + num_parts - 1) / num_parts, exp_bits);
+  std::vector<BigNumber> partial(num_parts);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_parts))
+#endif  // IPCL_USE_OMP
+  for (int p = 0; p < num_parts; p++) {
+    std::size_t begin = n * p / num_parts;
+    std::size_t end = n * (p + 1) / num_parts;
+    partial[p] = multiExpPart(&base[begin], &exp[begin], end - begin, mod,
+                              exp_bits, w);
+  }
+
+  BigNumber res = partial[0];
+  for (std::size_t p = 1; p < num_parts; p++)
+    res = mod.ModMul(res, partial[p]);
+  return res;
+}
+
+}  // namespace ipcl
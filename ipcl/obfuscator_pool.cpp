@@ -0,0 +1,185 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/obfuscator_pool.hpp"
+
+#include <algorithm>
+#include <chrono>  // NOLINT [build/c++11]
+#include <exception>
+#include <utility>
+
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+static std::size_t roundUpPow2(std::size_t n) {
+  std::size_t pow2 = 1;
+  while (pow2 < n) pow2 <<= 1;
+  return pow2;
+}
+
+ObfuscatorPool::ObfuscatorPool(Generator generator, std::size_t capacity,
+                               std::size_t low_water_mark, int num_threads)
+    : m_generator(std::move(generator)),
+      m_capacity(roundUpPow2(capacity)),
+      m_low_water_mark(low_water_mark),
+      m_mask(m_capacity - 1),
+      m_cells(new Cell[m_capacity]),
+      m_enqueue_pos(0),
+      m_dequeue_pos(0),
+      m_in_flight(0),
+      m_stop(false),
+      m_failed(false) {
+  ERROR_CHECK(capacity > 0, "ObfuscatorPool: capacity should be positive");
+  ERROR_CHECK(low_water_mark < m_capacity,
+              "ObfuscatorPool: low-water mark should be less than capacity");
+  ERROR_CHECK(num_threads > 0,
+              "ObfuscatorPool: number of refill threads should be positive");
+
+  for (std::size_t i = 0; i < m_capacity; i++)
+    m_cells[i].seq.store(i, std::memory_order_relaxed);
+
+  for (int i = 0; i < num_threads; i++)
+    m_threads.emplace_back(&ObfuscatorPool::refill, this);
+}
+
+ObfuscatorPool::~ObfuscatorPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_refill_cv.notify_all();
+  for (auto& t : m_threads) t.join();
+}
+
+// Bounded MPMC ring buffer: each cell carries a sequence number telling
+// whether it is ready to be written (seq == pos) or read (seq == pos + 1).
+bool ObfuscatorPool::push(BigNumber&& bn) {
+  Cell* cell;
+  std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    cell = &m_cells[pos & m_mask];
+    std::size_t seq = cell->seq.load(std::memory_order_acquire);
+    auto diff =
+        static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0) {
+      if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      return false;  // full
+    } else {
+      pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+  cell->value = std::move(bn);
+  cell->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool ObfuscatorPool::pop(BigNumber& bn) {
+  Cell* cell;
+  std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    cell = &m_cells[pos & m_mask];
+    std::size_t seq = cell->seq.load(std::memory_order_acquire);
+    auto diff = static_cast<std::ptrdiff_t>(seq) -
+                static_cast<std::ptrdiff_t>(pos + 1);
+    if (diff == 0) {
+      if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      return false;  // empty
+    } else {
+      pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+  bn = std::move(cell->value);
+  cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+  return true;
+}
+
+std::size_t ObfuscatorPool::getAvailable() const {
+  std::size_t enq = m_enqueue_pos.load(std::memory_order_acquire);
+  std::size_t deq = m_dequeue_pos.load(std::memory_order_acquire);
+  return (enq > deq) ? (enq - deq) : 0;
+}
+
+std::size_t ObfuscatorPool::getPending() const {
+  return getAvailable() + m_in_flight.load(std::memory_order_acquire);
+}
+
+// Claim a batch of the missing obfuscators, so that the refill threads
+// together never generate more than the pool can take
+std::size_t ObfuscatorPool::reserve() {
+  std::size_t in_flight = m_in_flight.load(std::memory_order_acquire);
+  for (;;) {
+    std::size_t pending = getAvailable() + in_flight;
+    if (pending >= m_capacity) return 0;
+    std::size_t batch = std::min<std::size_t>(m_capacity - pending,
+                                              IPCL_OBFUSCATOR_POOL_BATCH_SIZE);
+    if (m_in_flight.compare_exchange_weak(in_flight, in_flight + batch,
+                                          std::memory_order_acq_rel))
+      return batch;
+  }
+}
+
+std::vector<BigNumber> ObfuscatorPool::acquire(std::size_t sz) {
+  if (m_failed.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::rethrow_exception(m_error);
+  }
+
+  std::vector<BigNumber> obfuscator;
+  obfuscator.reserve(sz);
+
+  BigNumber bn;
+  while (obfuscator.size() < sz && pop(bn))
+    obfuscator.push_back(std::move(bn));
+
+  // Wake up the refill threads without taking the lock on the hot path, the
+  // threads also poll periodically so a missed notification only delays it.
+  if (getAvailable() < m_low_water_mark) m_refill_cv.notify_all();
+
+  return obfuscator;
+}
+
+void ObfuscatorPool::refill() {
+  constexpr auto poll_interval = std::chrono::milliseconds(10);
+
+  while (!m_stop) {
+    if (getPending() >= m_low_water_mark && getPending() > 0) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_refill_cv.wait_for(lock, poll_interval, [this] {
+        return m_stop || getPending() < m_low_water_mark;
+      });
+      continue;
+    }
+
+    // Fill up to capacity once the low-water mark is crossed
+    while (!m_stop) {
+      std::size_t batch = reserve();
+      if (batch == 0) break;
+
+      std::vector<BigNumber> obfuscator;
+      try {
+        obfuscator = m_generator(batch);
+      } catch (...) {
+        m_in_flight.fetch_sub(batch, std::memory_order_acq_rel);
+        // Surface the failure to the consumers instead of silently leaving
+        // them to compute the obfuscators inline
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_error) m_error = std::current_exception();
+        m_failed.store(true, std::memory_order_release);
+        return;
+      }
+
+      for (auto& bn : obfuscator)
+        if (!push(std::move(bn))) break;
+      m_in_flight.fetch_sub(batch, std::memory_order_acq_rel);
+    }
+  }
+}
+
+}  // namespace ipcl
@@ -0,0 +1,86 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/packed_bignum.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+constexpr std::size_t PACKED_LINE_LIMBS =
+    IPCL_PACKED_BIGNUM_ALIGNMENT / sizeof(Ipp64u);
+
+static int getBitLength(const BigNumber& bn) {
+  IppsBigNumSGN sgn;
+  int bits;
+  ippsRef_BN(&sgn, &bits, nullptr, BN(bn));
+  ERROR_CHECK(sgn == IppsBigNumPOS,
+              "PackedBigNumbers: negative big number cannot be packed");
+  return bits;
+}
+
+PackedBigNumbers::PackedBigNumbers(std::size_t size, int bits)
+    : m_size(size), m_bits(bits) {
+  ERROR_CHECK(bits > 0, "PackedBigNumbers: bit length should be positive");
+
+  std::size_t limbs = BITSIZE_DWORD(bits);
+  m_stride = (limbs + PACKED_LINE_LIMBS - 1) / PACKED_LINE_LIMBS *
+             PACKED_LINE_LIMBS;
+  m_limbs.assign(m_size * m_stride, 0);
+}
+
+PackedBigNumbers::PackedBigNumbers(const std::vector<BigNumber>& bn_v,
+                                   int bits) {
+  if (bits == 0) {
+    bits = 1;
+    for (const auto& bn : bn_v) bits = std::max(bits, getBitLength(bn));
+  }
+  *this = PackedBigNumbers(bn_v.size(), bits);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, m_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < m_size; i++) set(i, bn_v[i]);
+}
+
+std::vector<BigNumber> PackedBigNumbers::unpack() const {
+  std::vector<BigNumber> bn_v(m_size);
+
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, m_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < m_size; i++) bn_v[i] = get(i);
+
+  return bn_v;
+}
+
+BigNumber PackedBigNumbers::get(std::size_t idx) const {
+  ERROR_CHECK(idx < m_size, "PackedBigNumbers: get index is out of range");
+
+  return BigNumber(reinterpret_cast<const Ipp32u*>(data(idx)),
+                   BITSIZE_WORD(m_bits), IppsBigNumPOS);
+}
+
+void PackedBigNumbers::set(std::size_t idx, const BigNumber& bn) {
+  ERROR_CHECK(idx < m_size, "PackedBigNumbers: set index is out of range");
+
+  int bits = getBitLength(bn);
+  ERROR_CHECK(bits <= m_bits,
+              "PackedBigNumbers: big number exceeds the element bit length");
+
+  Ipp32u* bn_data;
+  ippsRef_BN(nullptr, nullptr, &bn_data, BN(bn));
+
+  Ipp64u* dst = data(idx);
+  std::memset(dst, 0, m_stride * sizeof(Ipp64u));
+  std::memcpy(dst, bn_data, BITSIZE_WORD(bits) * sizeof(Ipp32u));
+}
+
+}  // namespace ipcl
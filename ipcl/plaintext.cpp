@@ -4,6 +4,7 @@
 #include "ipcl/plaintext.hpp"
 
 #include <algorithm>
+#include <utility>
 
 #include "ipcl/ciphertext.hpp"
 #include "ipcl/utils/util.hpp"
@@ -18,6 +19,11 @@ PlainText::PlainText(const BigNumber& bn) : BaseText(bn) {}
 
 PlainText::PlainText(const std::vector<BigNumber>& bn_v) : BaseText(bn_v) {}
 
+PlainText::PlainText(BigNumber&& bn) : BaseText(std::move(bn)) {}
+
+PlainText::PlainText(std::vector<BigNumber>&& bn_v)
+    : BaseText(std::move(bn_v)) {}
+
 PlainText::PlainText(const PlainText& pt) : BaseText(pt) {}
 
 PlainText& PlainText::operator=(const PlainText& other) {
@@ -26,6 +32,14 @@ PlainText& PlainText::operator=(const PlainText& other) {
   return *this;
 }
 
+PlainText::PlainText(PlainText&& pt) noexcept : BaseText(std::move(pt)) {}
+
+PlainText& PlainText::operator=(PlainText&& other) noexcept {
+  BaseText::operator=(std::move(other));
+
+  return *this;
+}
+
 CipherText PlainText::operator+(const CipherText& other) const {
   return other.operator+(*this);
 }
@@ -43,17 +57,29 @@ PlainText::operator std::vector<uint32_t>() const {
   return v;
 }
 
-PlainText::operator BigNumber() const {
+PlainText::operator BigNumber() const& {
   ERROR_CHECK(m_size > 0, "PlainText: type conversion to BigNumber error");
   return m_texts[0];
 }
 
-PlainText::operator std::vector<BigNumber>() const {
+PlainText::operator BigNumber() && {
+  ERROR_CHECK(m_size > 0, "PlainText: type conversion to BigNumber error");
+  return std::move(m_texts[0]);
+}
+
+PlainText::operator std::vector<BigNumber>() const& {
   ERROR_CHECK(m_size > 0,
               "PlainText: type conversion to BigNumber vector error");
   return m_texts;
 }
 
+PlainText::operator std::vector<BigNumber>() && {
+  ERROR_CHECK(m_size > 0,
+              "PlainText: type conversion to BigNumber vector error");
+  m_size = 0;
+  return std::move(m_texts);
+}
+
 PlainText PlainText::rotate(int shift) const {
   ERROR_CHECK(m_size != 1, "rotate: Cannot rotate single CipherText");
   ERROR_CHECK(shift >= -m_size && shift <= m_size,
@@ -69,7 +95,7 @@ PlainText PlainText::rotate(int shift) const {
 
   std::vector<BigNumber> new_bn = getTexts();
   std::rotate(std::begin(new_bn), std::begin(new_bn) + shift, std::end(new_bn));
-  return PlainText(new_bn);
+  return PlainText(std::move(new_bn));
 }
 
 }  // namespace ipcl
@@ -7,6 +7,8 @@
 
 #include "crypto_mb/exp.h"
 #include "ipcl/mod_exp.hpp"
+#include "ipcl/mod_mul.hpp"
+#include "ipcl/utils/executor.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
@@ -24,10 +26,11 @@ static inline BigNumber lcm(const BigNumber& p, const BigNumber& q) {
 
 PrivateKey::PrivateKey(const PublicKey& pk, const BigNumber& p,
                        const BigNumber& q)
-    : m_n(pk.getN()),
+    : m_enable_crt(true),
+      m_n(pk.getN()),
       m_nsquare(pk.getNSQ()),
       m_g(pk.getG()),
-      m_enable_crt(true),
+      m_pk(pk.getHandle()),
       m_p((q < p) ? std::make_shared<BigNumber>(q)
                   : std::make_shared<BigNumber>(p)),
       m_q((q < p) ? std::make_shared<BigNumber>(p)
@@ -37,6 +40,9 @@ PrivateKey::PrivateKey(const PublicKey& pk, const BigNumber& p,
       m_psquare((*m_p) * (*m_p)),
       m_qsquare((*m_q) * (*m_q)),
       m_pinverse((*m_q).InverseMul(*m_p)),
+      m_psquareinverse(m_qsquare.InverseMul(m_psquare)),
+      m_pexp(*m_n % (m_psquare - *m_p)),
+      m_qexp(*m_n % (m_qsquare - *m_q)),
       m_hp(computeHfun(*m_p, m_psquare)),
       m_hq(computeHfun(*m_q, m_qsquare)),
       m_lambda(lcm(m_pminusone, m_qminusone)),
@@ -50,10 +56,11 @@ PrivateKey::PrivateKey(const PublicKey& pk, const BigNumber& p,
 
 PrivateKey::PrivateKey(const BigNumber& n, const BigNumber& p,
                        const BigNumber& q)
-    : m_n(std::make_shared<BigNumber>(n)),
+    : m_enable_crt(true),
+      m_n(std::make_shared<BigNumber>(n)),
       m_nsquare(std::make_shared<BigNumber>((*m_n) * (*m_n))),
       m_g(std::make_shared<BigNumber>((*m_n) + 1)),
-      m_enable_crt(true),
+      m_pk(PublicKey(n, n.BitSize()).getHandle()),
       m_p((q < p) ? std::make_shared<BigNumber>(q)
                   : std::make_shared<BigNumber>(p)),
       m_q((q < p) ? std::make_shared<BigNumber>(p)
@@ -63,6 +70,9 @@ PrivateKey::PrivateKey(const BigNumber& n, const BigNumber& p,
       m_psquare((*m_p) * (*m_p)),
       m_qsquare((*m_q) * (*m_q)),
       m_pinverse((*m_q).InverseMul(*m_p)),
+      m_psquareinverse(m_qsquare.InverseMul(m_psquare)),
+      m_pexp(*m_n % (m_psquare - *m_p)),
+      m_qexp(*m_n % (m_qsquare - *m_q)),
       m_hp(computeHfun(*m_p, m_psquare)),
       m_hq(computeHfun(*m_q, m_qsquare)),
       m_lambda(lcm(m_pminusone, m_qminusone)),
@@ -76,14 +86,19 @@ PrivateKey::PrivateKey(const BigNumber& n, const BigNumber& p,
 
 PlainText PrivateKey::decrypt(const CipherText& ct) const {
   ERROR_CHECK(m_isInitialized, "decrypt: Private key is NOT initialized.");
-  ERROR_CHECK(*(ct.getPubKey()->getN()) == *(this->getN()),
+  // keys built from the same public key share n
+  std::shared_ptr<BigNumber> ct_n = ct.getPubKey()->getN();
+  ERROR_CHECK(ct_n == m_n || *ct_n == *m_n,
               "decrypt: The value of N in public key mismatch.");
 
   std::size_t ct_size = ct.getSize();
   ERROR_CHECK(ct_size > 0, "decrypt: Cannot decrypt empty CipherText");
+  if (ct.isMontgomery()) return decrypt(ct.fromMontgomery());
 
   std::vector<BigNumber> pt_bn(ct_size);
-  std::vector<BigNumber> ct_bn = ct.getTexts();
+  const std::vector<BigNumber>& ct_bn = ct.getTexts();
+
+  HybridOpScope hybrid_op(HybridOp::DECRYPT);
 
   // If hybrid OPTIMAL mode is used, use a special ratio
   if (isHybridOptimal()) {
@@ -98,16 +113,93 @@ PlainText PrivateKey::decrypt(const CipherText& ct) const {
   else
     decryptRAW(pt_bn, ct_bn);
 
-  return PlainText(pt_bn);
+  return PlainText(std::move(pt_bn));
+}
+
+std::future<PlainText> PrivateKey::decryptAsync(
+    const CipherText& ciphertext) const {
+  HybridParams params = getHybridParams();
+  return Executor::getDefault().submit([params, sk = *this, ciphertext] {
+    setHybridParams(params);
+    return sk.decrypt(ciphertext);
+  });
+}
+
+CipherText PrivateKey::encrypt(const PlainText& pt, bool make_secure) const {
+  ERROR_CHECK(m_isInitialized, "encrypt: Private key is NOT initialized.");
+
+  std::size_t pt_size = pt.getSize();
+  ERROR_CHECK(pt_size > 0, "encrypt: Cannot encrypt empty PlainText");
+  const std::vector<BigNumber>& pt_bn = pt.getTexts();
+  std::vector<BigNumber> ct_bn(pt_size);
+  const BigNumber& n = *m_n;
+
+  HybridOpScope hybrid_op(HybridOp::ENCRYPT);
+
+  // If hybrid OPTIMAL mode is used, use a special ratio
+  if (isHybridOptimal()) {
+    float qat_ratio = (pt_size <= IPCL_WORKLOAD_SIZE_THRESHOLD)
+                          ? IPCL_HYBRID_MODEXP_RATIO_FULL
+                          : IPCL_HYBRID_MODEXP_RATIO_ENCRYPT;
+    setHybridRatio(qat_ratio, false);
+  }
+
+  // g^m = 1 + m * n is less than n^2 once m is reduced mod n
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, pt_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < pt_size; i++)
+    ct_bn[i] = n * (pt_bn[i] >= n ? pt_bn[i] % n : pt_bn[i]) + 1;
+
+  if (make_secure)
+    ct_bn = modMul(ct_bn, getObfuscatorCRT(pt_size), *m_nsquare);
+
+  return CipherText(*m_pk, std::move(ct_bn));
+}
+
+std::vector<BigNumber> PrivateKey::getObfuscatorCRT(std::size_t sz) const {
+  // r^n mod p^2 only depends on r mod p, as (r + kp)^p = r^p mod p^2, so a
+  // uniform r mod n is sampled as independent uniform residues mod p and q.
+  // The exponent n is reduced mod phi(p^2) = p(p - 1), and the p and q halves
+  // share the lanes of the multi-buffer kernel as in decryptCRT.
+  std::vector<BigNumber> rp = getRandomBNBelow(sz, *m_p);
+  std::vector<BigNumber> rq = getRandomBNBelow(sz, *m_q);
+  std::vector<BigNumber> res_p, res_q;
+  modExpCRT(res_p, res_q, rp, m_pexp, m_psquare, rq, m_qexp, m_qsquare);
+
+  std::vector<BigNumber> diff(sz), obf(sz);
+
+  // (xq - xp) mod q^2, with xp < p^2 < q^2
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, sz))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < sz; i++) {
+    const BigNumber& xp = res_p[i];
+    const BigNumber& xq = res_q[i];
+    diff[i] = (xq >= xp) ? xq - xp : xq + m_qsquare - xp;
+  }
+
+  std::vector<BigNumber> u = modMul(diff, {m_psquareinverse}, m_qsquare);
+
+#ifdef IPCL_USE_OMP
+  omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, sz))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < sz; i++) obf[i] = res_p[i] + u[i] * m_psquare;
+
+  return obf;
 }
 
 void PrivateKey::decryptRAW(std::vector<BigNumber>& plaintext,
                             const std::vector<BigNumber>& ciphertext) const {
   std::size_t v_size = plaintext.size();
 
-  std::vector<BigNumber> pow_lambda(v_size, m_lambda);
-  std::vector<BigNumber> modulo(v_size, *m_nsquare);
-  std::vector<BigNumber> res = modExp(ciphertext, pow_lambda, modulo);
+  std::vector<BigNumber> res = modExp(ciphertext, m_lambda, *m_nsquare);
 
 #ifdef IPCL_USE_OMP
   int omp_remaining_threads = OMPUtilities::MaxThreads;
@@ -127,9 +219,9 @@ void PrivateKey::decryptCRT(std::vector<BigNumber>& plaintext,
                             const std::vector<BigNumber>& ciphertext) const {
   std::size_t v_size = plaintext.size();
 
-  std::vector<BigNumber> basep(v_size), baseq(v_size);
-  std::vector<BigNumber> pm1(v_size, m_pminusone), qm1(v_size, m_qminusone);
-  std::vector<BigNumber> psq(v_size, m_psquare), qsq(v_size, m_qsquare);
+  // The p and q halves share the lanes of the multi-buffer kernel instead of
+  // running as two batches with padded tails
+  std::vector<BigNumber> base_p(v_size), base_q(v_size);
 
 #ifdef IPCL_USE_OMP
   int omp_remaining_threads = OMPUtilities::MaxThreads;
@@ -137,13 +229,16 @@ void PrivateKey::decryptCRT(std::vector<BigNumber>& plaintext,
     OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
 #endif  // IPCL_USE_OMP
   for (int i = 0; i < v_size; i++) {
-    basep[i] = ciphertext[i] % psq[i];
-    baseq[i] = ciphertext[i] % qsq[i];
+    // Based on the fact a^b mod n = (a mod n)^b mod n
+    base_p[i] = ciphertext[i] % m_psquare;
+    base_q[i] = ciphertext[i] % m_qsquare;
   }
 
-  // Based on the fact a^b mod n = (a mod n)^b mod n
-  std::vector<BigNumber> resp = modExp(basep, pm1, psq);
-  std::vector<BigNumber> resq = modExp(baseq, qm1, qsq);
+  std::vector<BigNumber> res_p, res_q;
+  modExpCRT(res_p, res_q, base_p, m_pminusone, m_psquare, base_q, m_qminusone,
+            m_qsquare);
+
+  std::vector<BigNumber> lp(v_size), lq(v_size);
 
 #ifdef IPCL_USE_OMP
   omp_remaining_threads = OMPUtilities::MaxThreads;
@@ -151,16 +246,37 @@ void PrivateKey::decryptCRT(std::vector<BigNumber>& plaintext,
     OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
 #endif  // IPCL_USE_OMP
   for (int i = 0; i < v_size; i++) {
-    BigNumber dp = computeLfun(resp[i], *m_p) * m_hp % (*m_p);
-    BigNumber dq = computeLfun(resq[i], *m_q) * m_hq % (*m_q);
-    plaintext[i] = computeCRT(dp, dq);
+    lp[i] = computeLfun(res_p[i], *m_p);
+    lq[i] = computeLfun(res_q[i], *m_q);
   }
+
+  // products by the key constants run batched on the multi-buffer kernel
+  computeCRT(plaintext, modMul(lp, {m_hp}, *m_p), modMul(lq, {m_hq}, *m_q));
 }
 
-BigNumber PrivateKey::computeCRT(const BigNumber& mp,
-                                 const BigNumber& mq) const {
-  BigNumber u = (mq - mp) * m_pinverse % (*m_q);
-  return mp + (u * (*m_p));
+void PrivateKey::computeCRT(std::vector<BigNumber>& res,
+                            const std::vector<BigNumber>& mp,
+                            const std::vector<BigNumber>& mq) const {
+  std::size_t v_size = res.size();
+  std::vector<BigNumber> diff(v_size);
+
+  // (mq - mp) mod q, with mp < p < q
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < v_size; i++)
+    diff[i] = (mq[i] >= mp[i]) ? mq[i] - mp[i] : mq[i] + *m_q - mp[i];
+
+  std::vector<BigNumber> u = modMul(diff, {m_pinverse}, *m_q);
+
+#ifdef IPCL_USE_OMP
+  omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < v_size; i++) res[i] = mp[i] + u[i] * (*m_p);
 }
 
 BigNumber PrivateKey::computeLfun(const BigNumber& a,
@@ -6,11 +6,16 @@
 #include <algorithm>
 #include <climits>
 #include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <random>
 
 #include "crypto_mb/exp.h"
 #include "ipcl/ciphertext.hpp"
 #include "ipcl/mod_exp.hpp"
+#include "ipcl/mod_mul.hpp"
+#include "ipcl/utils/executor.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
@@ -25,8 +30,63 @@ PublicKey::PublicKey(const BigNumber& n, int bits, bool enableDJN_)
       m_testv(false),
       m_hs(0),
       m_randbits(0) {
-  if (enableDJN_) this->enableDJN();  // sets m_enable_DJN
   m_isInitialized = true;
+  if (enableDJN_)
+    this->enableDJN();  // sets m_enable_DJN and interns the key
+  else
+    m_handle = intern();
+}
+
+std::shared_ptr<const PublicKey> PublicKey::getHandle() const {
+  if (m_handle) return m_handle;
+  if (auto self = m_self.lock()) return self;
+  return intern();
+}
+
+std::shared_ptr<const PublicKey> PublicKey::intern() const {
+  // Interned keys by n and DJN parameters, an entry expires with the last
+  // ciphertext or key referencing it
+  static std::mutex mutex;
+  static std::map<std::vector<Ipp32u>, std::weak_ptr<const PublicKey>> keys;
+
+  if (!m_isInitialized) return std::make_shared<const PublicKey>(*this);
+
+  // length of n, n, then the DJN flag, randbits and hs when enabled
+  std::vector<Ipp32u> id;
+  m_n->num2vec(id);
+  id.insert(id.begin(), static_cast<Ipp32u>(id.size()));
+  id.push_back(m_enable_DJN);
+  if (m_enable_DJN) {
+    std::vector<Ipp32u> hs;
+    m_hs.num2vec(hs);
+    id.push_back(static_cast<Ipp32u>(m_randbits));
+    id.insert(id.end(), hs.begin(), hs.end());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = keys.find(id);
+  if (it != keys.end()) {
+    if (auto handle = it->second.lock()) return handle;
+  }
+
+  // The interned copy only keeps the key parameters
+  auto key = std::make_shared<PublicKey>(*this);
+  key->m_handle.reset();
+  key->m_obf_pool.reset();
+  key->m_r.clear();
+  key->m_testv = false;
+  key->m_self = key;
+
+  for (auto e = keys.begin(); e != keys.end();)
+    e = e->second.expired() ? keys.erase(e) : std::next(e);
+  keys[id] = key;
+  return key;
+}
+
+void PublicKey::reintern() {
+  if (!m_isInitialized) return;
+  m_handle.reset();
+  m_handle = intern();
 }
 
 void PublicKey::enableDJN() {
@@ -46,47 +106,88 @@ void PublicKey::enableDJN() {
   m_randbits = m_bits >> 1;  // bits/2
 
   m_enable_DJN = true;
+  initDJNTable();
+  reintern();
+}
+
+void PublicKey::initDJNTable() {
+  m_hs_table =
+      std::make_shared<FixedBaseModExp>(m_hs, *m_nsquare, m_randbits);
+  restartObfuscatorPool();
 }
 
 std::vector<BigNumber> PublicKey::getDJNObfuscator(std::size_t sz) const {
   std::vector<BigNumber> r(sz);
-  std::vector<BigNumber> base(sz, m_hs);
-  std::vector<BigNumber> sq(sz, *m_nsquare);
 
   if (m_testv) {
     r = m_r;
   } else {
-    for (auto& r_ : r) {
-      r_ = getRandomBN(m_randbits);
-    }
+    r = getRandomBNs(sz, m_randbits);
   }
-  return modExp(base, r, sq);
+  return m_hs_table->exp(r);
 }
 
 std::vector<BigNumber> PublicKey::getNormalObfuscator(std::size_t sz) const {
   std::vector<BigNumber> r(sz);
-  std::vector<BigNumber> sq(sz, *m_nsquare);
-  std::vector<BigNumber> pown(sz, *m_n);
 
   if (m_testv) {
     r = m_r;
   } else {
-    for (int i = 0; i < sz; i++) {
-      r[i] = getRandomBN(m_bits);
-      r[i] = r[i] % (*m_n - 1) + 1;
-    }
+    r = getRandomBNBelow(sz, *m_n);  // uniform in [1, n)
   }
-  return modExp(r, pown, sq);
+  return modExp(r, *m_n, *m_nsquare);
+}
+
+std::vector<BigNumber> PublicKey::getObfuscator(std::size_t sz) const {
+  return m_enable_DJN ? getDJNObfuscator(sz) : getNormalObfuscator(sz);
 }
 
 void PublicKey::applyObfuscator(std::vector<BigNumber>& ciphertext) const {
   std::size_t sz = ciphertext.size();
-  std::vector<BigNumber> obfuscator =
-      m_enable_DJN ? getDJNObfuscator(sz) : getNormalObfuscator(sz);
-  BigNumber sq = *m_nsquare;
+  std::vector<BigNumber> obfuscator;
 
-  for (std::size_t i = 0; i < sz; ++i)
-    ciphertext[i] = sq.ModMul(ciphertext[i], obfuscator[i]);
+  // setRandom vectors are never served by the pool
+  if (m_obf_pool && !m_testv) {
+    obfuscator = m_obf_pool->acquire(sz);
+    if (obfuscator.size() < sz) {
+      std::vector<BigNumber> rest = getObfuscator(sz - obfuscator.size());
+      obfuscator.insert(obfuscator.end(), rest.begin(), rest.end());
+    }
+  } else {
+    obfuscator = getObfuscator(sz);
+  }
+
+  ciphertext = modMul(ciphertext, obfuscator, *m_nsquare);
+}
+
+void PublicKey::enableObfuscatorPool(std::size_t capacity,
+                                     std::size_t low_water_mark,
+                                     int num_threads) {
+  ERROR_CHECK(m_isInitialized,
+              "enableObfuscatorPool: Public key is NOT initialized.");
+
+  // The generator owns a pool-less copy of the key, so that the pool does
+  // not keep itself alive through the key it is attached to.
+  PublicKey key = *this;
+  key.m_obf_pool.reset();
+  key.m_testv = false;
+  key.m_r.clear();
+
+  m_obf_pool = std::make_shared<ObfuscatorPool>(
+      [key](std::size_t sz) { return key.getObfuscator(sz); }, capacity,
+      low_water_mark, num_threads);
+}
+
+void PublicKey::disableObfuscatorPool() { m_obf_pool.reset(); }
+
+void PublicKey::restartObfuscatorPool() {
+  if (!m_obf_pool) return;
+
+  std::size_t capacity = m_obf_pool->getCapacity();
+  std::size_t low_water_mark = m_obf_pool->getLowWaterMark();
+  int num_threads = m_obf_pool->getThreadCount();
+  m_obf_pool.reset();
+  enableObfuscatorPool(capacity, low_water_mark, num_threads);
 }
 
 void PublicKey::setRandom(const std::vector<BigNumber>& r) {
@@ -94,16 +195,32 @@ void PublicKey::setRandom(const std::vector<BigNumber>& r) {
   m_testv = true;
 }
 
-void PublicKey::setHS(const BigNumber& hs) { m_hs = hs; }
+void PublicKey::setHS(const BigNumber& hs) {
+  m_hs = hs;
+  if (m_enable_DJN) {
+    initDJNTable();
+    reintern();
+  }
+}
 
 std::vector<BigNumber> PublicKey::raw_encrypt(const std::vector<BigNumber>& pt,
                                               bool make_secure) const {
   std::size_t pt_size = pt.size();
 
   std::vector<BigNumber> ct(pt_size);
+  const BigNumber& n = *m_n;
 
-  for (std::size_t i = 0; i < pt_size; i++)
-    ct[i] = (*m_n * pt[i] + 1) % (*m_nsquare);
+  // g^m = 1 + m * n is less than n^2 once m is reduced mod n, plaintexts
+  // out of [0, n), negative ones included, are reduced first
+#ifdef IPCL_USE_OMP
+  int omp_remaining_threads = OMPUtilities::MaxThreads;
+#pragma omp parallel for num_threads( \
+    OMPUtilities::assignOMPThreads(omp_remaining_threads, pt_size))
+#endif  // IPCL_USE_OMP
+  for (int i = 0; i < pt_size; i++) {
+    bool in_range = pt[i] < n && pt[i] >= BigNumber::Zero();
+    ct[i] = n * (in_range ? pt[i] : pt[i] % n) + 1;
+  }
 
   if (make_secure) applyObfuscator(ct);
 
@@ -117,6 +234,8 @@ CipherText PublicKey::encrypt(const PlainText& pt, bool make_secure) const {
   ERROR_CHECK(pt_size > 0, "encrypt: Cannot encrypt empty PlainText");
   std::vector<BigNumber> ct_bn_v(pt_size);
 
+  HybridOpScope hybrid_op(HybridOp::ENCRYPT);
+
   // If hybrid OPTIMAL mode is used, use a special ratio
   if (isHybridOptimal()) {
     float qat_ratio = (pt_size <= IPCL_WORKLOAD_SIZE_THRESHOLD)
@@ -126,7 +245,16 @@ CipherText PublicKey::encrypt(const PlainText& pt, bool make_secure) const {
   }
 
   ct_bn_v = raw_encrypt(pt.getTexts(), make_secure);
-  return CipherText(*this, ct_bn_v);
+  return CipherText(*this, std::move(ct_bn_v));
+}
+
+std::future<CipherText> PublicKey::encryptAsync(const PlainText& pt,
+                                                bool make_secure) const {
+  HybridParams params = getHybridParams();
+  return Executor::getDefault().submit([params, pk = *this, pt, make_secure] {
+    setHybridParams(params);
+    return pk.encrypt(pt, make_secure);
+  });
 }
 
 void PublicKey::setDJN(const BigNumber& hs, int randbit) {
@@ -135,9 +263,12 @@ void PublicKey::setDJN(const BigNumber& hs, int randbit) {
   m_hs = hs;
   m_randbits = randbit;
   m_enable_DJN = true;
+  initDJNTable();
+  reintern();
 }
 
 void PublicKey::create(const BigNumber& n, int bits, bool enableDJN_) {
+  m_obf_pool.reset();
   m_n = std::make_shared<BigNumber>(n);
   m_g = std::make_shared<BigNumber>(*m_n + 1);
   m_nsquare = std::make_shared<BigNumber>((*m_n) * (*m_n));
@@ -149,9 +280,11 @@ void PublicKey::create(const BigNumber& n, int bits, bool enableDJN_) {
   } else {
     m_hs = BigNumber::Zero();
     m_randbits = 0;
+    m_hs_table.reset();
   }
   m_testv = false;
   m_isInitialized = true;
+  reintern();
   std::cout << "create complete" << std::endl;
 }
 
@@ -161,6 +294,10 @@ void PublicKey::create(const BigNumber& n, int bits, const BigNumber& hs,
   m_enable_DJN = true;
   m_hs = hs;
   m_randbits = randbits;
+  initDJNTable();
+
+  // intern the key with its DJN parameters
+  reintern();
 }
 
 }  // namespace ipcl
@@ -3,7 +3,10 @@
 
 #include "ipcl/utils/common.hpp"
 
+#include <cstring>
+
 #include "crypto_mb/exp.h"
+#include "ipcl/utils/drbg.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
@@ -46,28 +49,60 @@ IppStatus ippGenRandomBN(IppsBigNumState* rand, int bits, void* ctx) {
 #endif  // IPCL_RUNTIME_IPP_RNG
 }
 
-BigNumber getRandomBN(int bits) {
-  IppStatus stat;
-  int bn_buf_size;
+BigNumber getRandomBN(int bits) { return getRandomBNs(1, bits)[0]; }
+
+std::vector<BigNumber> getRandomBNs(std::size_t sz, int bits) {
+  ERROR_CHECK(bits > 0, "getRandomBNs: bit length should be positive");
 
-  int bn_len = BITSIZE_WORD(bits);
-  stat = ippsBigNumGetSize(bn_len, &bn_buf_size);
-  ERROR_CHECK(stat == ippStsNoErr,
-              "getRandomBN: get IppsBigNumState context error.");
+  int words = BITSIZE_WORD(bits);
+  std::vector<Ipp32u> limbs(sz * words);
+  DRBG::getInstance().generate(limbs.data(), limbs.size());
+
+  Ipp32u top_mask = (bits % 32) ? (1u << (bits % 32)) - 1 : ~0u;
+  std::vector<BigNumber> res(sz);
+  for (std::size_t i = 0; i < sz; i++) {
+    Ipp32u* data = limbs.data() + i * words;
+    data[words - 1] &= top_mask;
+    res[i] = BigNumber(data, words, IppsBigNumPOS);
+  }
+  std::memset(limbs.data(), 0, limbs.size() * sizeof(Ipp32u));
+  return res;
+}
 
-  IppsBigNumState* pBN =
-      reinterpret_cast<IppsBigNumState*>(alloca(bn_buf_size));
-  ERROR_CHECK(pBN != nullptr, "getRandomBN: big number alloca error");
+std::vector<BigNumber> getRandomBNBelow(std::size_t sz,
+                                        const BigNumber& bound) {
+  ERROR_CHECK(bound > BigNumber::One(),
+              "getRandomBNBelow: bound should be greater than 1");
 
-  stat = ippsBigNumInit(bn_len, pBN);
-  ERROR_CHECK(stat == ippStsNoErr,
-              "getRandomBN: init big number context error.");
+  int bits;
+  Ipp32u* bound_data;
+  ippsRef_BN(nullptr, &bits, &bound_data, BN(bound));
+  int words = BITSIZE_WORD(bits);
+  Ipp32u top_mask = (bits % 32) ? (1u << (bits % 32)) - 1 : ~0u;
 
-  stat = ippGenRandomBN(pBN, bits, NULL);
-  ERROR_CHECK(stat == ippStsNoErr,
-              "getRandomBN:  generate random big number error.");
+  // a draw of the bit length of bound is accepted with probability > 1/2,
+  // the candidates are compared word by word before building a BigNumber
+  auto in_range = [&](const Ipp32u* r) {
+    bool nonzero = false;
+    for (int k = 0; k < words; k++) nonzero |= (r[k] != 0);
+    if (!nonzero) return false;
+    for (int k = words - 1; k >= 0; k--)
+      if (r[k] != bound_data[k]) return r[k] < bound_data[k];
+    return false;
+  };
 
-  return BigNumber{pBN};
+  DRBG& drbg = DRBG::getInstance();
+  std::vector<Ipp32u> r(words);
+  std::vector<BigNumber> res(sz);
+  for (std::size_t i = 0; i < sz; i++) {
+    do {
+      drbg.generate(r.data(), words);
+      r[words - 1] &= top_mask;
+    } while (!in_range(r.data()));
+    res[i] = BigNumber(r.data(), words, IppsBigNumPOS);
+  }
+  std::memset(r.data(), 0, r.size() * sizeof(Ipp32u));
+  return res;
 }
 
 }  // namespace ipcl
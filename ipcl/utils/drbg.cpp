@@ -0,0 +1,178 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/utils/drbg.hpp"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "ipcl/utils/common.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+constexpr int CHACHA_BLOCK_WORDS = 16;
+constexpr int CHACHA_KEY_WORDS = 8;
+
+static inline Ipp32u rotl(Ipp32u v, int c) {
+  return (v << c) | (v >> (32 - c));
+}
+
+static inline void quarterRound(Ipp32u* x, int a, int b, int c, int d) {
+  x[a] += x[b];
+  x[d] = rotl(x[d] ^ x[a], 16);
+  x[c] += x[d];
+  x[b] = rotl(x[b] ^ x[c], 12);
+  x[a] += x[b];
+  x[d] = rotl(x[d] ^ x[a], 8);
+  x[c] += x[d];
+  x[b] = rotl(x[b] ^ x[c], 7);
+}
+
+// One ChaCha20 block of the key at the block counter, with a zero nonce
+static void chachaBlock(const Ipp32u* key, Ipp64u counter, Ipp32u* out) {
+  Ipp32u in[CHACHA_BLOCK_WORDS] = {0x61707865, 0x3320646e, 0x79622d32,
+                                   0x6b206574};  // "expand 32-byte k"
+  std::memcpy(in + 4, key, CHACHA_KEY_WORDS * sizeof(Ipp32u));
+  in[12] = static_cast<Ipp32u>(counter);
+  in[13] = static_cast<Ipp32u>(counter >> 32);
+
+  Ipp32u x[CHACHA_BLOCK_WORDS];
+  std::memcpy(x, in, sizeof(x));
+  for (int i = 0; i < 10; i++) {
+    quarterRound(x, 0, 4, 8, 12);
+    quarterRound(x, 1, 5, 9, 13);
+    quarterRound(x, 2, 6, 10, 14);
+    quarterRound(x, 3, 7, 11, 15);
+    quarterRound(x, 0, 5, 10, 15);
+    quarterRound(x, 1, 6, 11, 12);
+    quarterRound(x, 2, 7, 8, 13);
+    quarterRound(x, 3, 4, 9, 14);
+  }
+  for (int i = 0; i < CHACHA_BLOCK_WORDS; i++) out[i] = x[i] + in[i];
+}
+
+// Check whether ippGenRandom draws from RDSEED or RDRAND
+static bool hasHardwareEntropy() {
+#ifdef IPCL_RUNTIME_DETECT_CPU_FEATURES
+  return has_rdseed || has_rdrand;
+#elif defined(IPCL_RNG_INSTR_RDSEED) || defined(IPCL_RNG_INSTR_RDRAND)
+  return true;
+#else
+  return false;
+#endif  // IPCL_RUNTIME_DETECT_CPU_FEATURES
+}
+
+// Bumped in the child of every fork, so that the generators copied from the
+// parent notice it without a system call per request
+static std::atomic<Ipp64u> g_fork_generation(0);
+
+static void registerForkHandler() {
+  static const int stat = pthread_atfork(nullptr, nullptr, [] {
+    g_fork_generation.fetch_add(1, std::memory_order_relaxed);
+  });
+  ERROR_CHECK(stat == 0, std::string("DRBG: pthread_atfork error code = ") +
+                             std::to_string(stat));
+}
+
+DRBG& DRBG::getInstance() {
+  static thread_local DRBG drbg;
+  return drbg;
+}
+
+DRBG::DRBG()
+    : m_buffer(IPCL_DRBG_BUFFER_BLOCKS * CHACHA_BLOCK_WORDS),
+      m_pos(m_buffer.size()),
+      m_refills(0) {
+  registerForkHandler();
+  m_fork_generation = g_fork_generation.load(std::memory_order_relaxed);
+  if (!hasHardwareEntropy()) {
+    int prng_size;
+    ippsPRNGGetSize(&prng_size);
+    m_prng.resize(prng_size);
+    ippsPRNGInit(160, reinterpret_cast<IppsPRNGState*>(m_prng.data()));
+    seedPRNG();
+  }
+  getEntropy(m_key.data(), CHACHA_KEY_WORDS);
+}
+
+void DRBG::seedPRNG() {
+  // the IPP PRNG starts from a zero seed
+  std::random_device dev;
+  std::array<Ipp32u, 8> seed;
+  for (Ipp32u& w : seed) w = dev();
+  BigNumber seed_bn(seed.data(), seed.size());
+  std::memset(seed.data(), 0, sizeof(seed));
+
+  IppStatus stat = ippsPRNGSetSeed(
+      BN(seed_bn), reinterpret_cast<IppsPRNGState*>(m_prng.data()));
+  ERROR_CHECK(stat == ippStsNoErr,
+              std::string("DRBG: ippsPRNGSetSeed error code = ") +
+                  std::to_string(stat));
+}
+
+// RDSEED and RDRAND report a transient underflow of the entropy source with
+// ippStsErr, which is retried a bounded number of times
+void DRBG::getEntropy(Ipp32u* out, int words) {
+  void* ctx = m_prng.empty() ? nullptr : m_prng.data();
+  IppStatus stat = ippGenRandom(out, words * 32, ctx);
+  for (int retry = 0; stat == ippStsErr && hasHardwareEntropy() &&
+                      retry < IPCL_DRBG_ENTROPY_RETRIES;
+       retry++)
+    stat = ippGenRandom(out, words * 32, ctx);
+  ERROR_CHECK(stat == ippStsNoErr,
+              std::string("DRBG: entropy source error code = ") +
+                  std::to_string(stat));
+}
+
+void DRBG::reseed() {
+  std::array<Ipp32u, CHACHA_KEY_WORDS> seed;
+  getEntropy(seed.data(), CHACHA_KEY_WORDS);
+  for (int i = 0; i < CHACHA_KEY_WORDS; i++) m_key[i] ^= seed[i];
+  std::memset(seed.data(), 0, sizeof(seed));
+
+  std::memset(m_buffer.data(), 0, m_buffer.size() * sizeof(Ipp32u));
+  m_pos = m_buffer.size();
+  m_refills = 0;
+}
+
+void DRBG::refill() {
+  if (++m_refills > IPCL_DRBG_RESEED_INTERVAL) reseed();
+
+  for (int b = 0; b < IPCL_DRBG_BUFFER_BLOCKS; b++)
+    chachaBlock(m_key.data(), b, m_buffer.data() + b * CHACHA_BLOCK_WORDS);
+
+  // fast key erasure: the head of the keystream becomes the next key
+  std::memcpy(m_key.data(), m_buffer.data(), CHACHA_KEY_WORDS * sizeof(Ipp32u));
+  std::memset(m_buffer.data(), 0, CHACHA_KEY_WORDS * sizeof(Ipp32u));
+  m_pos = CHACHA_KEY_WORDS;
+}
+
+void DRBG::generate(Ipp32u* out, std::size_t words) {
+  // the child of a fork starts with a copy of the state of its parent
+  Ipp64u generation = g_fork_generation.load(std::memory_order_relaxed);
+  if (generation != m_fork_generation) {
+    m_fork_generation = generation;
+    if (!m_prng.empty()) seedPRNG();
+    reseed();
+  }
+
+  while (words > 0) {
+    if (m_pos == m_buffer.size()) refill();
+
+    std::size_t n = std::min(words, m_buffer.size() - m_pos);
+    std::memcpy(out, m_buffer.data() + m_pos, n * sizeof(Ipp32u));
+    // handed out output is wiped from the buffer
+    std::memset(m_buffer.data() + m_pos, 0, n * sizeof(Ipp32u));
+    m_pos += n;
+    out += n;
+    words -= n;
+  }
+}
+
+}  // namespace ipcl
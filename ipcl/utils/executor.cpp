@@ -0,0 +1,85 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/utils/executor.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif  // __linux__
+
+#include <string>
+
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+static bool pinThread(std::thread& t, int cpu) {
+#ifdef __linux__
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  return pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t),
+                                &cpuset) == 0;
+#else
+  return false;
+#endif  // __linux__
+}
+
+Executor::Executor(int num_threads, int first_cpu) : m_stop(false) {
+  ERROR_CHECK(num_threads > 0,
+              "Executor: number of worker threads should be positive");
+
+  bool pinned = true;
+  for (int i = 0; i < num_threads && pinned; i++) {
+    m_threads.emplace_back(&Executor::run, this);
+    if (first_cpu >= 0) pinned = pinThread(m_threads.back(), first_cpu + i);
+  }
+  if (!pinned) {
+    stop();
+    ERROR_CHECK(false, "Executor: failed to pin worker thread to CPU " +
+                           std::to_string(first_cpu + m_threads.size() - 1));
+  }
+}
+
+Executor::~Executor() { stop(); }
+
+void Executor::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  for (auto& t : m_threads)
+    if (t.joinable()) t.join();
+}
+
+Executor& Executor::getDefault() {
+  static Executor executor(IPCL_ASYNC_NUM_THREADS);
+  return executor;
+}
+
+void Executor::enqueue(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ERROR_CHECK(!m_stop, "Executor: submit on a stopped executor");
+    m_tasks.push_back(std::move(task));
+  }
+  m_cv.notify_one();
+}
+
+void Executor::run() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+      if (m_tasks.empty()) return;  // stopped and drained
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace ipcl
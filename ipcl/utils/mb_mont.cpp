@@ -0,0 +1,234 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/utils/mb_mont.hpp"
+
+#include <immintrin.h>
+
+#include "ipcl/utils/common.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+constexpr int MB_DIGIT_BITS = 52;
+constexpr Ipp64u MB_DIGIT_MASK = (1ULL << MB_DIGIT_BITS) - 1;
+
+// Every digit of the lazy accumulators of the multiplication collects up to
+// 4 * digits terms below 2^52, 158 digits keep them well below 2^64
+constexpr int MB_MAX_DIGITS =
+    (IPCL_MB_MONT_MAX_MOD_BITS + MB_DIGIT_BITS - 1) / MB_DIGIT_BITS;
+
+// Split a non-negative big number into radix 2^52 digits, written stride
+// limbs apart
+static void toDigits(const BigNumber& bn, int digits, Ipp64u* out,
+                     std::size_t stride) {
+  int bits;
+  Ipp32u* data;
+  ippsRef_BN(nullptr, &bits, &data, BN(bn));
+  int words = BITSIZE_WORD(bits);
+
+  for (int k = 0; k < digits; k++) {
+    int idx = (k * MB_DIGIT_BITS) >> 5;
+    int shift = (k * MB_DIGIT_BITS) & 31;
+    Ipp64u v = 0;
+    if (idx < words) v = static_cast<Ipp64u>(data[idx]) >> shift;
+    if (idx + 1 < words)
+      v |= static_cast<Ipp64u>(data[idx + 1]) << (32 - shift);
+    if (shift > 12 && idx + 2 < words)
+      v |= static_cast<Ipp64u>(data[idx + 2]) << (64 - shift);
+    out[k * stride] = v & MB_DIGIT_MASK;
+  }
+}
+
+// Join radix 2^52 digits, read stride limbs apart, into a big number
+static BigNumber fromDigits(const Ipp64u* in, std::size_t stride,
+                            int digits) {
+  int words = (digits * MB_DIGIT_BITS + 31) / 32;
+  std::vector<Ipp32u> data(words + 2, 0);
+
+  for (int k = 0; k < digits; k++) {
+    int idx = (k * MB_DIGIT_BITS) >> 5;
+    int shift = (k * MB_DIGIT_BITS) & 31;
+    Ipp64u v = in[k * stride];
+    data[idx] |= static_cast<Ipp32u>(v << shift);
+    data[idx + 1] |= static_cast<Ipp32u>(v >> (32 - shift));
+    if (shift > 12) data[idx + 2] |= static_cast<Ipp32u>(v >> (64 - shift));
+  }
+  return BigNumber(data.data(), words, IppsBigNumPOS);
+}
+
+// The operand ranges are told from the sign and bit lengths, the exact
+// comparison is left to operands as long as the modulus
+void toMBLane(const BigNumber& bn, const BigNumber& mod, int digits,
+              Ipp64u* lane) {
+  IppsBigNumSGN sgn;
+  int bits, mod_bits;
+  ippsRef_BN(&sgn, &bits, nullptr, BN(bn));
+  ippsRef_BN(nullptr, &mod_bits, nullptr, BN(mod));
+
+  if (sgn == IppsBigNumNEG || bits > mod_bits ||
+      (bits == mod_bits && bn >= mod))
+    toDigits(bn % mod, digits, lane, IPCL_CRYPTO_MB_SIZE);
+  else
+    toDigits(bn, digits, lane, IPCL_CRYPTO_MB_SIZE);
+}
+
+// below 2^(bits(m) - 1) * R, the operand is less than m * R
+void toMBLaneWide(const BigNumber& bn, const BigNumber& mod, int digits,
+                  Ipp64u* lane) {
+  IppsBigNumSGN sgn;
+  int bits, mod_bits;
+  ippsRef_BN(&sgn, &bits, nullptr, BN(bn));
+  ippsRef_BN(nullptr, &mod_bits, nullptr, BN(mod));
+
+  if (sgn == IppsBigNumNEG || bits >= mod_bits + MB_DIGIT_BITS * digits)
+    toDigits(bn % mod, 2 * digits, lane, IPCL_CRYPTO_MB_SIZE);
+  else
+    toDigits(bn, 2 * digits, lane, IPCL_CRYPTO_MB_SIZE);
+}
+
+MBMontContext createMBMontContext(const BigNumber& mod) {
+  MBMontContext ctx;
+  ctx.digits = (mod.BitSize() + MB_DIGIT_BITS - 1) / MB_DIGIT_BITS;
+  ERROR_CHECK(ctx.digits <= MB_MAX_DIGITS,
+              "createMBMontContext: modulus is too long");
+
+  ctx.mod.resize(ctx.digits);
+  toDigits(mod, ctx.digits, ctx.mod.data(), 1);
+
+  // Newton iteration doubles the correct low bits of mod^-1 each step
+  Ipp64u inv = 1;
+  for (int i = 0; i < 6; i++) inv *= 2 - ctx.mod[0] * inv;
+  ctx.k0 = (0 - inv) & MB_DIGIT_MASK;
+
+  int r2_bits = 2 * MB_DIGIT_BITS * ctx.digits;
+  std::vector<Ipp32u> r2(r2_bits / 32 + 1, 0);
+  r2.back() = 1u << (r2_bits % 32);
+  BigNumber rr = BigNumber(r2.data(), r2.size(), IppsBigNumPOS) % mod;
+
+  ctx.rr.resize(ctx.digits * IPCL_CRYPTO_MB_SIZE);
+  for (int lane = 0; lane < IPCL_CRYPTO_MB_SIZE; lane++)
+    toDigits(rr, ctx.digits, ctx.rr.data() + lane, IPCL_CRYPTO_MB_SIZE);
+  return ctx;
+}
+
+// Normalize the lazy accumulators of a value less than 2m and subtract m
+// from the lanes not less than m
+__attribute__((target("avx512f"))) static void mbReduce(
+    Ipp64u* res, __m512i* acc, const MBMontContext& ctx) {
+  const int n = ctx.digits;
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i mask = _mm512_set1_epi64(MB_DIGIT_MASK);
+
+  __m512i carry = zero;
+  for (int j = 0; j < n; j++) {
+    __m512i t = _mm512_add_epi64(acc[j], carry);
+    carry = _mm512_srli_epi64(t, MB_DIGIT_BITS);
+    acc[j] = _mm512_and_si512(t, mask);
+  }
+
+  __m512i borrow = zero;
+  for (int j = 0; j < n; j++) {
+    __m512i t = _mm512_sub_epi64(acc[j], _mm512_set1_epi64(ctx.mod[j]));
+    t = _mm512_sub_epi64(t, borrow);
+    borrow = _mm512_srli_epi64(t, 63);
+    _mm512_store_si512(res + j * IPCL_CRYPTO_MB_SIZE,
+                       _mm512_and_si512(t, mask));
+  }
+  __mmask8 ge = _mm512_cmpge_epu64_mask(carry, borrow);
+  for (int j = 0; j < n; j++) {
+    __m512i d = _mm512_load_si512(res + j * IPCL_CRYPTO_MB_SIZE);
+    _mm512_store_si512(res + j * IPCL_CRYPTO_MB_SIZE,
+                       _mm512_mask_blend_epi64(ge, acc[j], d));
+  }
+}
+
+// The accumulators are normalized only once at the end
+__attribute__((target("avx512f,avx512ifma"))) void mbMontMul(
+    Ipp64u* res, const Ipp64u* a, const Ipp64u* b, const MBMontContext& ctx,
+    Ipp64u* acc_buff) {
+  const int n = ctx.digits;
+  __m512i* acc = reinterpret_cast<__m512i*>(acc_buff);
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i k0 = _mm512_set1_epi64(ctx.k0);
+
+  for (int j = 0; j <= n; j++) acc[j] = zero;
+
+  for (int i = 0; i < n; i++) {
+    __m512i bi = _mm512_load_si512(b + i * IPCL_CRYPTO_MB_SIZE);
+    for (int j = 0; j < n; j++) {
+      __m512i aj = _mm512_load_si512(a + j * IPCL_CRYPTO_MB_SIZE);
+      acc[j] = _mm512_madd52lo_epu64(acc[j], aj, bi);
+      acc[j + 1] = _mm512_madd52hi_epu64(acc[j + 1], aj, bi);
+    }
+
+    // u makes the lowest digit divisible by 2^52
+    __m512i u = _mm512_madd52lo_epu64(zero, acc[0], k0);
+    for (int j = 0; j < n; j++) {
+      __m512i mj = _mm512_set1_epi64(ctx.mod[j]);
+      acc[j] = _mm512_madd52lo_epu64(acc[j], mj, u);
+      acc[j + 1] = _mm512_madd52hi_epu64(acc[j + 1], mj, u);
+    }
+
+    // shift down one digit
+    __m512i carry = _mm512_srli_epi64(acc[0], MB_DIGIT_BITS);
+    for (int j = 0; j < n; j++) acc[j] = acc[j + 1];
+    acc[0] = _mm512_add_epi64(acc[0], carry);
+    acc[n] = zero;
+  }
+
+  mbReduce(res, acc, ctx);
+}
+
+__attribute__((target("avx512f,avx512ifma"))) void mbMontRedc(
+    Ipp64u* res, const Ipp64u* t, const MBMontContext& ctx,
+    Ipp64u* acc_buff) {
+  const int n = ctx.digits;
+  __m512i* acc = reinterpret_cast<__m512i*>(acc_buff);
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i k0 = _mm512_set1_epi64(ctx.k0);
+
+  for (int j = 0; j < 2 * n; j++)
+    acc[j] = _mm512_load_si512(t + j * IPCL_CRYPTO_MB_SIZE);
+
+  // clear the low digits one at a time, carrying into the next one
+  for (int i = 0; i < n; i++) {
+    __m512i u = _mm512_madd52lo_epu64(zero, acc[i], k0);
+    for (int j = 0; j < n; j++) {
+      __m512i mj = _mm512_set1_epi64(ctx.mod[j]);
+      acc[i + j] = _mm512_madd52lo_epu64(acc[i + j], mj, u);
+      acc[i + j + 1] = _mm512_madd52hi_epu64(acc[i + j + 1], mj, u);
+    }
+    acc[i + 1] =
+        _mm512_add_epi64(acc[i + 1], _mm512_srli_epi64(acc[i], MB_DIGIT_BITS));
+  }
+
+  mbReduce(res, acc + n, ctx);
+}
+
+BigNumber fromMBLane(const Ipp64u* lane, int digits) {
+  return fromDigits(lane, IPCL_CRYPTO_MB_SIZE, digits);
+}
+
+__attribute__((target("avx512f"))) void mbSelect(
+    Ipp64u* res, const Ipp64u* table, int entries, const Ipp64u* idx,
+    int digits) {
+  const std::size_t lanes_size = digits * IPCL_CRYPTO_MB_SIZE;
+  const __m512i idx_v = _mm512_loadu_si512(idx);
+
+  for (int j = 0; j < digits; j++)
+    _mm512_store_si512(res + j * IPCL_CRYPTO_MB_SIZE, _mm512_setzero_si512());
+
+  for (int e = 0; e < entries; e++) {
+    __mmask8 hit = _mm512_cmpeq_epu64_mask(idx_v, _mm512_set1_epi64(e));
+    const Ipp64u* entry = table + e * lanes_size;
+    for (int j = 0; j < digits; j++) {
+      __m512i r = _mm512_load_si512(res + j * IPCL_CRYPTO_MB_SIZE);
+      __m512i t = _mm512_load_si512(entry + j * IPCL_CRYPTO_MB_SIZE);
+      _mm512_store_si512(res + j * IPCL_CRYPTO_MB_SIZE,
+                         _mm512_mask_blend_epi64(hit, r, t));
+    }
+  }
+}
+
+}  // namespace ipcl
@@ -0,0 +1,98 @@
+// Copyright (C) 2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/utils/mont_cache.hpp"
+
+#include <cstring>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+namespace {
+
+struct MontCacheEntry {
+  IppsExpMethod method;
+  std::vector<Ipp32u> mod;
+  std::vector<Ipp8u> state;
+};
+
+// Most recently used entry first
+thread_local std::list<MontCacheEntry> g_mont_cache;
+
+}  // namespace
+
+static MontCacheEntry createMontEntry(const Ipp32u* mod_data, int mod_words,
+                                      IppsExpMethod method) {
+  MontCacheEntry entry;
+  entry.method = method;
+  entry.mod.assign(mod_data, mod_data + mod_words);
+
+  int size;
+  IppStatus stat = ippsMontGetSize(method, mod_words, &size);
+  ERROR_CHECK(stat == ippStsNoErr,
+              "getMontState: get the size of IppsMontState context error.");
+
+  entry.state.resize(size);
+  auto pMont = reinterpret_cast<IppsMontState*>(entry.state.data());
+  stat = ippsMontInit(method, mod_words, pMont);
+  ERROR_CHECK(stat == ippStsNoErr, "getMontState: init Mont context error.");
+
+  stat = ippsMontSet(mod_data, mod_words, pMont);
+  ERROR_CHECK(stat == ippStsNoErr, "getMontState: set Mont input error.");
+  return entry;
+}
+
+IppsMontState* getMontState(const BigNumber& mod, IppsExpMethod method) {
+  int mod_bits;
+  Ipp32u* mod_data;
+  ippsRef_BN(nullptr, &mod_bits, &mod_data, BN(mod));
+  int mod_words = BITSIZE_WORD(mod_bits);
+
+  for (auto it = g_mont_cache.begin(); it != g_mont_cache.end(); ++it) {
+    if (it->method != method ||
+        it->mod.size() != static_cast<std::size_t>(mod_words) ||
+        std::memcmp(it->mod.data(), mod_data, mod_words * sizeof(Ipp32u)))
+      continue;
+    if (it != g_mont_cache.begin())
+      g_mont_cache.splice(g_mont_cache.begin(), g_mont_cache, it);
+    return reinterpret_cast<IppsMontState*>(g_mont_cache.front().state.data());
+  }
+
+  g_mont_cache.push_front(createMontEntry(mod_data, mod_words, method));
+  if (g_mont_cache.size() > IPCL_MONT_CACHE_SIZE) g_mont_cache.pop_back();
+  return reinterpret_cast<IppsMontState*>(g_mont_cache.front().state.data());
+}
+
+IppsExpMethod getMontExpMethod(int exp_bits) {
+  return (exp_bits > IPCL_MONT_SLIDING_WINDOW_THRESHOLD) ? IppsSlidingWindows
+                                                         : IppsBinaryMethod;
+}
+
+BigNumber montMul(const BigNumber& a, const BigNumber& b,
+                  const BigNumber& mod) {
+  BigNumber res(mod);
+  IppStatus stat = ippsMontMul(BN(a), BN(b), getMontState(mod), BN(res));
+  ERROR_CHECK(stat == ippStsNoErr,
+              std::string("ippsMontMul: error code = ") + std::to_string(stat));
+  return res;
+}
+
+BigNumber toMontForm(const BigNumber& a, const BigNumber& mod) {
+  BigNumber res(mod);
+  IppStatus stat = ippsMontForm(BN(a), getMontState(mod), BN(res));
+  ERROR_CHECK(stat == ippStsNoErr,
+              "toMontForm: convert big number into Mont form error.");
+  return res;
+}
+
+BigNumber fromMontForm(const BigNumber& a, const BigNumber& mod) {
+  return montMul(a, BigNumber::One(), mod);
+}
+
+void clearMontCache() { g_mont_cache.clear(); }
+
+}  // namespace ipcl
@@ -2,10 +2,12 @@
 // SPDX-License-Identifier: Apache-2.0
 /// @file heqat/bnops.c
 
+#ifndef HE_QAT_EMU
 #include <cpa.h>
 #include <cpa_cy_im.h>
 #include <cpa_cy_ln.h>
 #include <icp_sal_poll.h>
+#endif
 
 #include "heqat/bnops.h"
 #include "heqat/common/consts.h"
@@ -3,7 +3,9 @@
 /// @file heqat/cb.c
 
 // QAT-API headers
+#ifndef HE_QAT_EMU
 #include <cpa.h>
+#endif
 
 // C support libraries
 #include <pthread.h>
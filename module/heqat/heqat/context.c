@@ -4,9 +4,11 @@
 
 #define _GNU_SOURCE
 
+#ifndef HE_QAT_EMU
 #include <icp_sal_user.h>
 #include <icp_sal_poll.h>
 #include <qae_mem.h>
+#endif
 
 #include <pthread.h>
 #include <stdint.h>
@@ -14,6 +16,7 @@
 
 #include "heqat/common/types.h"
 #include "heqat/common/utils.h"
+#include "heqat/common/emu.h"
 #include "heqat/context.h"
 
 #ifdef USER_SPACE
@@ -22,9 +25,11 @@
 #define MAX_INSTANCES 1
 #endif
 
+#ifndef HE_QAT_EMU
 // Utilities functions from qae_mem.h header
 extern CpaStatus qaeMemInit(void);
 extern void qaeMemDestroy(void);
+#endif
 
 static volatile HE_QAT_STATUS context_state = HE_QAT_STATUS_INACTIVE;
 static pthread_mutex_t context_lock;
@@ -62,10 +67,16 @@ static Cpa16U nextInstance = 0;
 static CpaInstanceHandle get_qat_instance() {
     static CpaInstanceHandle cyInstHandles[MAX_INSTANCES];
     CpaStatus status = CPA_STATUS_SUCCESS;
+#ifndef HE_QAT_EMU
     CpaInstanceInfo2 info = {0};
+#endif
 
     if (0 == numInstances) {
+#ifdef HE_QAT_EMU
+        status = HE_QAT_emuGetNumInstances(&numInstances);
+#else
         status = cpaCyGetNumInstances(&numInstances);
+#endif
         if (numInstances >= MAX_INSTANCES) {
             numInstances = MAX_INSTANCES;
         }
@@ -81,6 +92,9 @@ static CpaInstanceHandle get_qat_instance() {
         HE_QAT_PRINT_DBG("Found %d CyInstances.\n", numInstances);
 
         if ((status == CPA_STATUS_SUCCESS) && (numInstances > 0)) {
+#ifdef HE_QAT_EMU
+            status = HE_QAT_emuGetInstances(numInstances, cyInstHandles);
+#else
             status = cpaCyGetInstances(numInstances, cyInstHandles);
 
             // List instances and their characteristics
@@ -104,6 +118,7 @@ static CpaInstanceHandle get_qat_instance() {
                              info.physInstId.kptAcHandle);
 #endif
             }
+#endif  // HE_QAT_EMU
             HE_QAT_PRINT_DBG("Next Instance: %d.\n", nextInstance);
 
             if (status == CPA_STATUS_SUCCESS)
@@ -129,7 +144,9 @@ static CpaInstanceHandle get_qat_instance() {
 /// @brief
 /// Acquire QAT instances and set up QAT execution environment.
 HE_QAT_STATUS acquire_qat_devices() {
+#ifndef HE_QAT_EMU
     CpaStatus status = CPA_STATUS_FAIL;
+#endif
 
     pthread_mutex_lock(&context_lock);
 
@@ -140,6 +157,15 @@ HE_QAT_STATUS acquire_qat_devices() {
         return HE_QAT_STATUS_SUCCESS;
     }
 
+#ifdef HE_QAT_EMU
+    // Start the engine workers of the emulated accelerator
+    if (HE_QAT_STATUS_SUCCESS != HE_QAT_emuStart()) {
+        pthread_mutex_unlock(&context_lock);
+        HE_QAT_PRINT_ERR("Failed to start emulated accelerator.\n");
+        return HE_QAT_STATUS_FAIL;
+    }
+    HE_QAT_PRINT_DBG("Emulated accelerator successfully started.\n");
+#else
     // Initialize QAT memory pool allocator
     status = qaeMemInit();
     if (CPA_STATUS_SUCCESS != status) {
@@ -157,6 +183,7 @@ HE_QAT_STATUS acquire_qat_devices() {
         return HE_QAT_STATUS_FAIL;
     }
     HE_QAT_PRINT_DBG("SAL user process successfully started.\n");
+#endif
 
     CpaInstanceHandle _inst_handle[HE_QAT_NUM_ACTIVE_INSTANCES];
     for (unsigned int i = 0; i < HE_QAT_NUM_ACTIVE_INSTANCES; i++) {
@@ -203,10 +230,13 @@ HE_QAT_STATUS acquire_qat_devices() {
     pthread_cond_init(&outstanding.any_ready_buffer, NULL);
 
     // Creating QAT instances (consumer threads) to process op requests
+    // Wrap around the online CPUs on hosts with fewer cores than instances
     cpu_set_t cpus;
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cpus < 1) num_cpus = 1;
     for (int i = 0; i < HE_QAT_NUM_ACTIVE_INSTANCES; i++) {
         CPU_ZERO(&cpus);
-        CPU_SET(i, &cpus);
+        CPU_SET(i % num_cpus, &cpus);
         pthread_attr_init(&he_qat_inst_attr[i]);
         pthread_attr_setaffinity_np(&he_qat_inst_attr[i], sizeof(cpu_set_t),
                                     &cpus);
@@ -280,6 +310,11 @@ HE_QAT_STATUS release_qat_devices() {
     // Deactivate context (this will terminate buffer manager thread
     context_state = HE_QAT_STATUS_INACTIVE;
 
+#ifdef HE_QAT_EMU
+    // Stop the engine workers of the emulated accelerator
+    HE_QAT_emuStop();
+    HE_QAT_PRINT_DBG("Stopped emulated accelerator.\n");
+#else
     // Stop QAT SSL service
     icp_sal_userStop();
     HE_QAT_PRINT_DBG("Stopped SAL user process.\n");
@@ -287,6 +322,7 @@ HE_QAT_STATUS release_qat_devices() {
     // Release QAT allocated memory
     qaeMemDestroy();
     HE_QAT_PRINT_DBG("Release QAT memory.\n");
+#endif
 
     numInstances = 0;
     nextInstance = 0;
@@ -16,15 +16,36 @@ double time_taken = 0.0;
 #endif
 
 // QAT-API headers
+#ifndef HE_QAT_EMU
 #include <cpa.h>
 #include <cpa_cy_im.h>
 #include <cpa_cy_ln.h>
 #include <icp_sal_poll.h>
+#endif
 
 // Local headers
 #include "heqat/common/utils.h"
 #include "heqat/common/consts.h"
 #include "heqat/common/types.h"
+#include "heqat/common/emu.h"
+
+// Device services used by the processing and polling threads
+#ifdef HE_QAT_EMU
+#define HE_QAT_START_INSTANCE(inst) HE_QAT_emuStartInstance(inst)
+#define HE_QAT_STOP_INSTANCE(inst) HE_QAT_emuStopInstance(inst)
+#define HE_QAT_SET_ADDRESS_TRANSLATION(inst, fn) CPA_STATUS_SUCCESS
+#define HE_QAT_POLL_INSTANCE(inst, quota) HE_QAT_emuPollInstance(inst, quota)
+#define HE_QAT_LN_MOD_EXP(inst, cb, tag, op_data, result) \
+    HE_QAT_emuLnModExp(inst, cb, tag, op_data, result)
+#else
+#define HE_QAT_START_INSTANCE(inst) cpaCyStartInstance(inst)
+#define HE_QAT_STOP_INSTANCE(inst) cpaCyStopInstance(inst)
+#define HE_QAT_SET_ADDRESS_TRANSLATION(inst, fn) \
+    cpaCySetAddressTranslation(inst, fn)
+#define HE_QAT_POLL_INSTANCE(inst, quota) icp_sal_CyPollInstance(inst, quota)
+#define HE_QAT_LN_MOD_EXP(inst, cb, tag, op_data, result) \
+    cpaCyLnModExp(inst, cb, tag, op_data, result)
+#endif
 
 // Warn user on selected execution mode
 #ifdef HE_QAT_SYNC_MODE
@@ -325,7 +346,7 @@ static void* start_inst_polling(void* _inst_config) {
     // What is harmful for polling without performing any operation?
     config->polling = 1;
     while (config->polling) {
-        icp_sal_CyPollInstance(config->inst_handle, 0);
+        HE_QAT_POLL_INSTANCE(config->inst_handle, 0);
         // OS_SLEEP(50);
         HE_QAT_SLEEP(50, HE_QAT_MICROSEC);
     }
@@ -399,11 +420,11 @@ void* start_instances(void* _config) {
         // assert(0 == config->active);
         // assert(NULL == config->inst_handle);
 
-        status = cpaCyStartInstance(config->inst_config[j].inst_handle);
+        status = HE_QAT_START_INSTANCE(config->inst_config[j].inst_handle);
         config->inst_config[j].status = status;
         if (CPA_STATUS_SUCCESS == status) {
             HE_QAT_PRINT_DBG("Cpa CyInstance has successfully started.\n");
-            status = cpaCySetAddressTranslation(
+            status = HE_QAT_SET_ADDRESS_TRANSLATION(
                 config->inst_config[j].inst_handle, HE_QAT_virtToPhys);
         }
 
@@ -497,7 +518,7 @@ void* start_instances(void* _config) {
 #ifdef HE_QAT_PERF
                     gettimeofday(&request->start, NULL);
 #endif
-                    status = cpaCyLnModExp(
+                    status = HE_QAT_LN_MOD_EXP(
                         config->inst_config[next_instance].inst_handle,
                         (CpaCyGenFlatBufCbFunc)
                             request->callback_func,  // lnModExpCallback,
@@ -595,12 +616,12 @@ void* start_perform_op(void* _inst_config) {
     // assert(0 == config->active);
     // assert(NULL == config->inst_handle);
 
-    status = cpaCyStartInstance(config->inst_handle);
+    status = HE_QAT_START_INSTANCE(config->inst_handle);
     config->status = status;
     if (CPA_STATUS_SUCCESS == status) {
         HE_QAT_PRINT_DBG("Cpa CyInstance has successfully started.\n");
-        status =
-            cpaCySetAddressTranslation(config->inst_handle, HE_QAT_virtToPhys);
+        status = HE_QAT_SET_ADDRESS_TRANSLATION(config->inst_handle,
+                                                HE_QAT_virtToPhys);
     }
 
     pthread_cond_signal(&config->ready);
@@ -691,7 +712,7 @@ void* start_perform_op(void* _inst_config) {
 #ifdef HE_QAT_PERF
                     gettimeofday(&request->start, NULL);
 #endif
-                    status = cpaCyLnModExp(
+                    status = HE_QAT_LN_MOD_EXP(
                         config->inst_handle,
                         (CpaCyGenFlatBufCbFunc)
                             request->callback_func,  // lnModExpCallback,
@@ -792,7 +813,7 @@ void stop_perform_op(HE_QAT_InstConfig* config, unsigned num_inst) {
             if (config[i].inst_handle == NULL) continue;
 
             HE_QAT_PRINT_DBG("cpaCyStopInstance\n");
-            status = cpaCyStopInstance(config[i].inst_handle);
+            status = HE_QAT_STOP_INSTANCE(config[i].inst_handle);
             if (CPA_STATUS_SUCCESS != status) {
                 HE_QAT_PRINT_ERR("Failed to stop QAT instance #%d\n", i);
             }
@@ -0,0 +1,434 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/emu.c
+
+#ifdef HE_QAT_EMU
+
+// C support libraries
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <openssl/bn.h>
+
+// Local headers
+#include "heqat/common/consts.h"
+#include "heqat/common/types.h"
+#include "heqat/common/utils.h"
+#include "heqat/common/emu.h"
+
+#pragma message "Software-emulated accelerator backend."
+
+struct HE_QAT_EmuInstance;
+
+typedef struct HE_QAT_EmuJob {
+    struct HE_QAT_EmuJob* next;
+    struct HE_QAT_EmuInstance* inst;  ///< Instance the request was sent to.
+    CpaCyGenFlatBufCbFunc callback;
+    void* tag;
+    const CpaCyLnModExpOpData* op_data;
+    CpaFlatBuffer* result;
+    CpaStatus status;
+    unsigned long long ready_ns;  ///< Earliest time the response is polled.
+} HE_QAT_EmuJob;
+
+typedef struct {
+    HE_QAT_EmuJob* head;
+    HE_QAT_EmuJob* tail;
+} HE_QAT_EmuQueue;
+
+typedef struct HE_QAT_EmuInstance {
+    volatile int started;
+    unsigned int inflight;  ///< Requests submitted and not yet polled.
+    HE_QAT_EmuQueue responses;
+    pthread_mutex_t mutex;  ///< Protects inflight and responses.
+} HE_QAT_EmuInstance;
+
+static HE_QAT_EmuConfig emu_config;
+static int emu_config_set = 0;
+static HE_QAT_EmuInstance emu_instances[HE_QAT_NUM_ACTIVE_INSTANCES];
+static pthread_once_t emu_once = PTHREAD_ONCE_INIT;
+
+static pthread_t* emu_engines = NULL;
+static unsigned int emu_engine_count = 0;
+static volatile int emu_running = 0;
+static HE_QAT_EmuQueue emu_requests = {NULL, NULL};
+static pthread_mutex_t emu_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t emu_any_request = PTHREAD_COND_INITIALIZER;
+
+static void emu_init_instances(void) {
+    for (unsigned int i = 0; i < HE_QAT_NUM_ACTIVE_INSTANCES; i++) {
+        emu_instances[i].started = 0;
+        emu_instances[i].inflight = 0;
+        emu_instances[i].responses.head = NULL;
+        emu_instances[i].responses.tail = NULL;
+        pthread_mutex_init(&emu_instances[i].mutex, NULL);
+    }
+}
+
+static void emu_push(HE_QAT_EmuQueue* queue, HE_QAT_EmuJob* job) {
+    job->next = NULL;
+    if (NULL == queue->tail)
+        queue->head = job;
+    else
+        queue->tail->next = job;
+    queue->tail = job;
+}
+
+static HE_QAT_EmuJob* emu_pop(HE_QAT_EmuQueue* queue) {
+    HE_QAT_EmuJob* job = queue->head;
+    if (NULL != job) {
+        queue->head = job->next;
+        if (NULL == queue->head) queue->tail = NULL;
+        job->next = NULL;
+    }
+    return job;
+}
+
+static unsigned long long emu_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * HE_QAT_NANOSEC + ts.tv_nsec;
+}
+
+static void emu_sleep_until(unsigned long long deadline_ns) {
+    struct timespec ts;
+    ts.tv_sec = deadline_ns / HE_QAT_NANOSEC;
+    ts.tv_nsec = deadline_ns % HE_QAT_NANOSEC;
+    while (EINTR ==
+           clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) {
+    }
+}
+
+static unsigned int emu_getenv(const char* name, unsigned int value) {
+    const char* str = getenv(name);
+    if (NULL == str || '\0' == *str) return value;
+
+    char* end = NULL;
+    unsigned long val = strtoul(str, &end, 10);
+    if ('\0' != *end) {
+        HE_QAT_PRINT_ERR("Ignoring invalid value of %s: %s\n", name, str);
+        return value;
+    }
+    return (unsigned int)val;
+}
+
+static void emu_load_config(HE_QAT_EmuConfig* config) {
+    config->num_engines = emu_getenv("HE_QAT_EMU_ENGINES", NUM_PKE_SLICES);
+    config->latency_us = emu_getenv("HE_QAT_EMU_LATENCY_US", 0);
+    config->service_us = emu_getenv("HE_QAT_EMU_SERVICE_US", 0);
+    config->ring_size =
+        emu_getenv("HE_QAT_EMU_RING_SIZE", HE_QAT_EMU_RING_SIZE);
+    if (0 == config->num_engines) config->num_engines = 1;
+    if (0 == config->ring_size) config->ring_size = HE_QAT_EMU_RING_SIZE;
+}
+
+/// @brief Compute the modular exponentiation of a request on the CPU.
+static CpaStatus emu_mod_exp(const CpaCyLnModExpOpData* op_data,
+                             CpaFlatBuffer* result, BN_CTX* ctx) {
+    if (NULL == result->pData) return CPA_STATUS_INVALID_PARAM;
+
+    CpaStatus status = CPA_STATUS_FAIL;
+
+    BN_CTX_start(ctx);
+    BIGNUM* b = BN_CTX_get(ctx);
+    BIGNUM* e = BN_CTX_get(ctx);
+    BIGNUM* m = BN_CTX_get(ctx);
+    BIGNUM* r = BN_CTX_get(ctx);
+    if (NULL != r &&
+        BN_bin2bn(op_data->base.pData, op_data->base.dataLenInBytes, b) &&
+        BN_bin2bn(op_data->exponent.pData, op_data->exponent.dataLenInBytes,
+                  e) &&
+        BN_bin2bn(op_data->modulus.pData, op_data->modulus.dataLenInBytes,
+                  m) &&
+        !BN_is_zero(m)) {
+        // The exponent may be secret (e.g. decryption), OpenSSL only has a
+        // constant-time path for odd moduli
+        if (BN_is_odd(m)) BN_set_flags(e, BN_FLG_CONSTTIME);
+        if (BN_mod_exp(r, b, e, m, ctx) &&
+            BN_bn2binpad(r, result->pData, result->dataLenInBytes) >= 0)
+            status = CPA_STATUS_SUCCESS;
+    }
+    BN_CTX_end(ctx);
+
+    return status;
+}
+
+/// @brief Worker thread emulating one PKE engine of the device.
+static void* emu_engine(void* arg) {
+    (void)arg;
+
+    BN_CTX* ctx = BN_CTX_new();
+    if (NULL == ctx) {
+        HE_QAT_PRINT_ERR("Failed to allocate BN_CTX for emulated engine.\n");
+        pthread_exit(NULL);
+    }
+
+    unsigned long long service_ns = emu_config.service_us * 1000ULL;
+    for (;;) {
+        pthread_mutex_lock(&emu_mutex);
+        while (emu_running && NULL == emu_requests.head)
+            pthread_cond_wait(&emu_any_request, &emu_mutex);
+        if (!emu_running) {
+            pthread_mutex_unlock(&emu_mutex);
+            break;
+        }
+        HE_QAT_EmuJob* job = emu_pop(&emu_requests);
+        pthread_mutex_unlock(&emu_mutex);
+
+        unsigned long long start = emu_now_ns();
+        job->status = emu_mod_exp(job->op_data, job->result, ctx);
+
+        // Hold the engine for the configured service time
+        if (emu_now_ns() < start + service_ns)
+            emu_sleep_until(start + service_ns);
+
+        unsigned long long now = emu_now_ns();
+        if (job->ready_ns < now) job->ready_ns = now;
+
+        pthread_mutex_lock(&job->inst->mutex);
+        emu_push(&job->inst->responses, job);
+        pthread_mutex_unlock(&job->inst->mutex);
+    }
+
+    BN_CTX_free(ctx);
+    pthread_exit(NULL);
+}
+
+/// @brief Invoke the callbacks of the responses available on an instance.
+/// @param[in] inst Emulated instance.
+/// @param[in] quota Maximum number of responses to deliver (0 for all).
+/// @param[in] flush Deliver the responses regardless of their latency.
+static Cpa32U emu_deliver(HE_QAT_EmuInstance* inst, Cpa32U quota, int flush) {
+    HE_QAT_EmuQueue ready = {NULL, NULL};
+    Cpa32U count = 0;
+    unsigned long long now = emu_now_ns();
+
+    pthread_mutex_lock(&inst->mutex);
+    HE_QAT_EmuJob* prev = NULL;
+    HE_QAT_EmuJob* job = inst->responses.head;
+    while (NULL != job && (0 == quota || count < quota)) {
+        HE_QAT_EmuJob* next = job->next;
+        if (flush || job->ready_ns <= now) {
+            if (NULL == prev)
+                inst->responses.head = next;
+            else
+                prev->next = next;
+            if (inst->responses.tail == job) inst->responses.tail = prev;
+            emu_push(&ready, job);
+            inst->inflight--;
+            count++;
+        } else {
+            prev = job;
+        }
+        job = next;
+    }
+    pthread_mutex_unlock(&inst->mutex);
+
+    // Callbacks are invoked outside the lock, as from the driver
+    while (NULL != (job = emu_pop(&ready))) {
+        job->callback(job->tag, job->status, (void*)job->op_data,
+                      job->result);
+        free(job);
+    }
+
+    return count;
+}
+
+HE_QAT_STATUS HE_QAT_emuSetConfig(const HE_QAT_EmuConfig* config) {
+    if (NULL == config || 0 == config->num_engines || 0 == config->ring_size)
+        return HE_QAT_STATUS_INVALID_PARAM;
+
+    pthread_mutex_lock(&emu_mutex);
+    if (emu_running) {
+        pthread_mutex_unlock(&emu_mutex);
+        HE_QAT_PRINT_ERR("Emulated device is running.\n");
+        return HE_QAT_STATUS_FAIL;
+    }
+    emu_config = *config;
+    emu_config_set = 1;
+    pthread_mutex_unlock(&emu_mutex);
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+void HE_QAT_emuGetConfig(HE_QAT_EmuConfig* config) {
+    if (NULL == config) return;
+
+    pthread_mutex_lock(&emu_mutex);
+    if (emu_running || emu_config_set)
+        *config = emu_config;
+    else
+        emu_load_config(config);
+    pthread_mutex_unlock(&emu_mutex);
+}
+
+HE_QAT_STATUS HE_QAT_emuStart(void) {
+    pthread_once(&emu_once, emu_init_instances);
+
+    pthread_mutex_lock(&emu_mutex);
+    if (emu_running) {
+        pthread_mutex_unlock(&emu_mutex);
+        return HE_QAT_STATUS_SUCCESS;
+    }
+
+    if (!emu_config_set) emu_load_config(&emu_config);
+
+    emu_engines =
+        (pthread_t*)malloc(sizeof(pthread_t) * emu_config.num_engines);
+    if (NULL == emu_engines) {
+        pthread_mutex_unlock(&emu_mutex);
+        HE_QAT_PRINT_ERR("Failed to allocate emulated engines.\n");
+        return HE_QAT_STATUS_FAIL;
+    }
+
+    emu_running = 1;
+    for (emu_engine_count = 0; emu_engine_count < emu_config.num_engines;
+         emu_engine_count++) {
+        if (0 != pthread_create(&emu_engines[emu_engine_count], NULL,
+                                emu_engine, NULL))
+            break;
+    }
+    pthread_mutex_unlock(&emu_mutex);
+
+    if (emu_engine_count < emu_config.num_engines) {
+        HE_QAT_PRINT_ERR("Failed to create emulated engine threads.\n");
+        HE_QAT_emuStop();
+        return HE_QAT_STATUS_FAIL;
+    }
+
+    HE_QAT_PRINT_DBG(
+        "Emulated device started. [engines: %u latency: %u us service: %u us "
+        "ring size: %u]\n",
+        emu_config.num_engines, emu_config.latency_us, emu_config.service_us,
+        emu_config.ring_size);
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+void HE_QAT_emuStop(void) {
+    pthread_mutex_lock(&emu_mutex);
+    if (NULL == emu_engines) {
+        pthread_mutex_unlock(&emu_mutex);
+        return;
+    }
+    emu_running = 0;
+    pthread_cond_broadcast(&emu_any_request);
+    pthread_mutex_unlock(&emu_mutex);
+
+    for (unsigned int i = 0; i < emu_engine_count; i++)
+        pthread_join(emu_engines[i], NULL);
+    free(emu_engines);
+    emu_engines = NULL;
+    emu_engine_count = 0;
+
+    // Fail the requests that never reached an engine
+    pthread_mutex_lock(&emu_mutex);
+    HE_QAT_EmuJob* job = NULL;
+    while (NULL != (job = emu_pop(&emu_requests))) {
+        job->status = CPA_STATUS_FAIL;
+        pthread_mutex_lock(&job->inst->mutex);
+        emu_push(&job->inst->responses, job);
+        pthread_mutex_unlock(&job->inst->mutex);
+    }
+    pthread_mutex_unlock(&emu_mutex);
+
+    for (unsigned int i = 0; i < HE_QAT_NUM_ACTIVE_INSTANCES; i++) {
+        emu_deliver(&emu_instances[i], 0, 1);
+        emu_instances[i].started = 0;
+    }
+
+    HE_QAT_PRINT_DBG("Emulated device stopped.\n");
+}
+
+CpaStatus HE_QAT_emuGetNumInstances(Cpa16U* pNumInstances) {
+    if (NULL == pNumInstances) return CPA_STATUS_INVALID_PARAM;
+    *pNumInstances = HE_QAT_NUM_ACTIVE_INSTANCES;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus HE_QAT_emuGetInstances(Cpa16U numInstances,
+                                 CpaInstanceHandle* cyInstances) {
+    if (NULL == cyInstances || numInstances > HE_QAT_NUM_ACTIVE_INSTANCES)
+        return CPA_STATUS_INVALID_PARAM;
+    for (Cpa16U i = 0; i < numInstances; i++)
+        cyInstances[i] = (CpaInstanceHandle)&emu_instances[i];
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus HE_QAT_emuStartInstance(CpaInstanceHandle instanceHandle) {
+    HE_QAT_EmuInstance* inst = (HE_QAT_EmuInstance*)instanceHandle;
+    if (NULL == inst) return CPA_STATUS_INVALID_PARAM;
+    if (!emu_running) return CPA_STATUS_FAIL;
+    inst->started = 1;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus HE_QAT_emuStopInstance(CpaInstanceHandle instanceHandle) {
+    HE_QAT_EmuInstance* inst = (HE_QAT_EmuInstance*)instanceHandle;
+    if (NULL == inst) return CPA_STATUS_INVALID_PARAM;
+    inst->started = 0;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus HE_QAT_emuLnModExp(const CpaInstanceHandle instanceHandle,
+                             const CpaCyGenFlatBufCbFunc pLnModExpCb,
+                             void* pCallbackTag,
+                             const CpaCyLnModExpOpData* pLnModExpOpData,
+                             CpaFlatBuffer* pResult) {
+    HE_QAT_EmuInstance* inst = (HE_QAT_EmuInstance*)instanceHandle;
+    if (NULL == inst || NULL == pLnModExpCb || NULL == pLnModExpOpData ||
+        NULL == pResult)
+        return CPA_STATUS_INVALID_PARAM;
+    if (!emu_running || !inst->started) return CPA_STATUS_FAIL;
+
+    // Emulate a full request ring
+    pthread_mutex_lock(&inst->mutex);
+    if (inst->inflight >= emu_config.ring_size) {
+        pthread_mutex_unlock(&inst->mutex);
+        return CPA_STATUS_RETRY;
+    }
+    inst->inflight++;
+    pthread_mutex_unlock(&inst->mutex);
+
+    HE_QAT_EmuJob* job = (HE_QAT_EmuJob*)malloc(sizeof(HE_QAT_EmuJob));
+    if (NULL == job) {
+        pthread_mutex_lock(&inst->mutex);
+        inst->inflight--;
+        pthread_mutex_unlock(&inst->mutex);
+        return CPA_STATUS_RESOURCE;
+    }
+    job->inst = inst;
+    job->callback = pLnModExpCb;
+    job->tag = pCallbackTag;
+    job->op_data = pLnModExpOpData;
+    job->result = pResult;
+    job->status = CPA_STATUS_FAIL;
+    job->ready_ns = emu_now_ns() + emu_config.latency_us * 1000ULL;
+
+    pthread_mutex_lock(&emu_mutex);
+    if (!emu_running) {
+        pthread_mutex_unlock(&emu_mutex);
+        free(job);
+        pthread_mutex_lock(&inst->mutex);
+        inst->inflight--;
+        pthread_mutex_unlock(&inst->mutex);
+        return CPA_STATUS_FAIL;
+    }
+    emu_push(&emu_requests, job);
+    pthread_cond_signal(&emu_any_request);
+    pthread_mutex_unlock(&emu_mutex);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus HE_QAT_emuPollInstance(CpaInstanceHandle instanceHandle,
+                                 Cpa32U response_quota) {
+    HE_QAT_EmuInstance* inst = (HE_QAT_EmuInstance*)instanceHandle;
+    if (NULL == inst) return CPA_STATUS_INVALID_PARAM;
+
+    if (0 == emu_deliver(inst, response_quota, 0)) return CPA_STATUS_RETRY;
+    return CPA_STATUS_SUCCESS;
+}
+
+#endif  // HE_QAT_EMU
@@ -8,6 +8,7 @@
 #include "heqat/common/consts.h"
 #include "heqat/common/types.h"
 #include "heqat/common/utils.h"
+#include "heqat/common/emu.h"
 
 #ifdef __cplusplus
 #ifdef HE_QAT_MISC
@@ -14,5 +14,6 @@
 #define HE_QAT_MAX_RETRY 100
 #define RESTART_LATENCY_MICROSEC 600
 #define NUM_PKE_SLICES 6
+#define HE_QAT_EMU_RING_SIZE 64
 
 #endif  // _HE_QAT_CONST_H_
@@ -0,0 +1,65 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/common/cpa_emu.h
+///
+/// @details
+///     Subset of the QAT CPA API types used by the library, for builds with
+///     the software-emulated accelerator (HE_QAT_EMU) that do not have the
+///     QAT SDK installed. The definitions follow cpa.h and cpa_cy_ln.h so
+///     that the request pipeline compiles unchanged against either.
+
+#pragma once
+
+#ifndef _HE_QAT_CPA_EMU_H_
+#define _HE_QAT_CPA_EMU_H_
+
+#ifdef HE_QAT_EMU
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+typedef uint8_t Cpa8U;
+typedef uint16_t Cpa16U;
+typedef uint32_t Cpa32U;
+typedef uint64_t Cpa64U;
+
+typedef enum { CPA_FALSE = (0 == 1), CPA_TRUE = (1 == 1) } CpaBoolean;
+
+typedef Cpa64U CpaPhysicalAddr;
+
+typedef void* CpaInstanceHandle;
+
+typedef int32_t CpaStatus;
+#define CPA_STATUS_SUCCESS (0)
+#define CPA_STATUS_FAIL (-1)
+#define CPA_STATUS_RETRY (-2)
+#define CPA_STATUS_RESOURCE (-3)
+#define CPA_STATUS_INVALID_PARAM (-4)
+
+/// @brief Contiguous buffer of octets.
+typedef struct _CpaFlatBuffer {
+    Cpa32U dataLenInBytes;  ///< Length of the data in bytes.
+    Cpa8U* pData;           ///< Data, big-endian for the big number operations.
+} CpaFlatBuffer;
+
+/// @brief Operands of the modular exponentiation base ^ exponent mod modulus.
+typedef struct _CpaCyLnModExpOpData {
+    CpaFlatBuffer modulus;   ///< Modulus.
+    CpaFlatBuffer base;      ///< Base.
+    CpaFlatBuffer exponent;  ///< Exponent.
+} CpaCyLnModExpOpData;
+
+/// @brief Completion callback of the operations with a flat buffer output.
+typedef void (*CpaCyGenFlatBufCbFunc)(void* pCallbackTag, CpaStatus status,
+                                      void* pOpdata, CpaFlatBuffer* pOut);
+
+#ifdef __cplusplus
+}  // extern "C" {
+#endif
+
+#endif  // HE_QAT_EMU
+
+#endif  // _HE_QAT_CPA_EMU_H_
@@ -0,0 +1,96 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/common/emu.h
+///
+/// @details
+///     Software-emulated accelerator backend. When the library is built with
+///     HE_QAT_EMU, the request pipeline (scheduler, internal buffer,
+///     processing and polling threads, callbacks) runs unchanged, but the
+///     requests are serviced by CPU worker threads emulating the PKE engines
+///     of a QAT device instead of the QAT driver. The latency and throughput
+///     of the emulated device are configurable so that the queueing overhead
+///     of the pipeline can be profiled and tuned without hardware.
+
+#pragma once
+
+#ifndef _HE_QAT_EMU_H_
+#define _HE_QAT_EMU_H_
+
+#ifdef HE_QAT_EMU
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "heqat/common/cpa_emu.h"
+#include "heqat/common/types.h"
+
+/// @brief Configuration of the emulated accelerator.
+/// @details Each field can also be set through the environment variables
+/// HE_QAT_EMU_ENGINES, HE_QAT_EMU_LATENCY_US, HE_QAT_EMU_SERVICE_US and
+/// HE_QAT_EMU_RING_SIZE, which are read when the device is started.
+typedef struct {
+    unsigned int num_engines;  ///< Number of CPU worker threads emulating the
+                               ///< PKE engines (device concurrency).
+    unsigned int latency_us;   ///< Minimum time in microseconds between the
+                               ///< submission of a request and its response.
+    unsigned int service_us;   ///< Minimum time in microseconds an engine is
+                               ///< busy per request (bounds the throughput).
+    unsigned int ring_size;    ///< Maximum number of in-flight requests per
+                               ///< instance before CPA_STATUS_RETRY.
+} HE_QAT_EmuConfig;
+
+/// @brief Set the configuration of the emulated accelerator.
+/// @details Must be called before acquire_qat_devices(), the configuration
+/// is applied when the emulated device is started.
+/// @param[in] config Emulated device configuration.
+HE_QAT_STATUS HE_QAT_emuSetConfig(const HE_QAT_EmuConfig* config);
+
+/// @brief Get the configuration of the emulated accelerator.
+/// @param[out] config Emulated device configuration.
+void HE_QAT_emuGetConfig(HE_QAT_EmuConfig* config);
+
+/// @brief Start the worker threads of the emulated accelerator.
+HE_QAT_STATUS HE_QAT_emuStart(void);
+
+/// @brief Stop the worker threads of the emulated accelerator.
+/// @details Requests still queued are completed with CPA_STATUS_FAIL.
+void HE_QAT_emuStop(void);
+
+/// @brief Emulated counterpart of cpaCyGetNumInstances().
+CpaStatus HE_QAT_emuGetNumInstances(Cpa16U* pNumInstances);
+
+/// @brief Emulated counterpart of cpaCyGetInstances().
+CpaStatus HE_QAT_emuGetInstances(Cpa16U numInstances,
+                                 CpaInstanceHandle* cyInstances);
+
+/// @brief Emulated counterpart of cpaCyStartInstance().
+CpaStatus HE_QAT_emuStartInstance(CpaInstanceHandle instanceHandle);
+
+/// @brief Emulated counterpart of cpaCyStopInstance().
+CpaStatus HE_QAT_emuStopInstance(CpaInstanceHandle instanceHandle);
+
+/// @brief Emulated counterpart of cpaCyLnModExp().
+/// @details Queue the request for the engine workers. The callback is
+/// invoked from HE_QAT_emuPollInstance() once the request is serviced and its
+/// latency has elapsed.
+CpaStatus HE_QAT_emuLnModExp(const CpaInstanceHandle instanceHandle,
+                             const CpaCyGenFlatBufCbFunc pLnModExpCb,
+                             void* pCallbackTag,
+                             const CpaCyLnModExpOpData* pLnModExpOpData,
+                             CpaFlatBuffer* pResult);
+
+/// @brief Emulated counterpart of icp_sal_CyPollInstance().
+/// @param[in] instanceHandle Instance to poll responses from.
+/// @param[in] response_quota Maximum number of responses to deliver (0 for
+/// all the available responses).
+CpaStatus HE_QAT_emuPollInstance(CpaInstanceHandle instanceHandle,
+                                 Cpa32U response_quota);
+
+#ifdef __cplusplus
+}  // extern "C" {
+#endif
+
+#endif  // HE_QAT_EMU
+
+#endif  // _HE_QAT_EMU_H_
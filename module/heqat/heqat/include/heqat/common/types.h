@@ -19,9 +19,13 @@ extern "C" {
 #endif
 
 // QATLib Headers
+#ifdef HE_QAT_EMU
+#include "heqat/common/cpa_emu.h"
+#else
 #include <cpa.h>
 #include <cpa_cy_im.h>
 #include <cpa_cy_ln.h>
+#endif
 
 #include "heqat/common/consts.h"
 
@@ -20,7 +20,12 @@ extern "C" {
 #include <openssl/bn.h>
 #include <errno.h>
 
+#ifdef HE_QAT_EMU
+#include <stdint.h>
+#include <stdlib.h>
+#else
 #include <qae_mem.h>
+#endif
 
 #include "heqat/common/types.h"
 
@@ -89,7 +94,13 @@ static __inline HE_QAT_STATUS HE_QAT_memAllocContig(void** ppMemAddr,
                                                     Cpa32U sizeBytes,
                                                     Cpa32U alignment,
                                                     Cpa32U node) {
+#ifdef HE_QAT_EMU
+    // No device DMA with the emulated accelerator, host memory is enough
+    (void)node;
+    if (0 != posix_memalign(ppMemAddr, alignment, sizeBytes)) *ppMemAddr = NULL;
+#else
     *ppMemAddr = qaeMemAllocNUMA(sizeBytes, node, alignment);
+#endif
     if (NULL == *ppMemAddr) {
         return HE_QAT_STATUS_FAIL;
     }
@@ -107,7 +118,11 @@ static __inline HE_QAT_STATUS HE_QAT_memAllocContig(void** ppMemAddr,
 ///                          If pointer is NULL, the function will exit silently
 static __inline void HE_QAT_memFreeContig(void** ppMemAddr) {
     if (NULL != *ppMemAddr) {
+#ifdef HE_QAT_EMU
+        free(*ppMemAddr);
+#else
         qaeMemFreeNUMA(ppMemAddr);
+#endif
         *ppMemAddr = NULL;
     }
 }
@@ -151,7 +166,11 @@ static __inline HE_QAT_STATUS HE_QAT_sleep(unsigned int time,
 /// @retval CpaPhysicalAddr Physical address or 0 in
 /// case of error
 static __inline CpaPhysicalAddr HE_QAT_virtToPhys(void* virtAddr) {
+#ifdef HE_QAT_EMU
+    return (CpaPhysicalAddr)(uintptr_t)virtAddr;
+#else
     return (CpaPhysicalAddr)qaeVirtToPhysNUMA(virtAddr);
+#endif
 }
 
 BIGNUM* generateTestBNData(int nbits);
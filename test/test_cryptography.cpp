@@ -1,12 +1,24 @@
 // Copyright (C) 2021 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT [build/c++11]
 #include <climits>
+#include <future>  // NOLINT [build/c++11]
 #include <random>
+#include <thread>  // NOLINT [build/c++11]
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "ipcl/ipcl.hpp"
+#include "ipcl/utils/drbg.hpp"
+#include "ipcl/utils/mont_cache.hpp"
 
 constexpr int SELF_DEF_NUM_VALUES = 18;
 constexpr float SELF_DEF_HYBRID_QAT_RATIO = 0.5;
@@ -43,6 +55,82 @@ TEST(CryptoTest, CryptoTest) {
   }
 }
 
+TEST(CryptoTest, AsyncTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+  const int num_batches = 4;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048, true);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, 0xFFFF);
+
+  std::vector<std::vector<uint32_t>> exp_value(
+      num_batches, std::vector<uint32_t>(num_values));
+  std::vector<std::future<ipcl::CipherText>> ct_f;
+  for (int j = 0; j < num_batches; j++) {
+    for (int i = 0; i < num_values; i++) exp_value[j][i] = dist(rng);
+    ct_f.push_back(key.pub_key.encryptAsync(ipcl::PlainText(exp_value[j])));
+  }
+
+  // all batches are in flight, chain the next stage as each one completes
+  ipcl::PlainText three(3u);
+  std::vector<std::future<ipcl::CipherText>> prod_f;
+  for (auto& f : ct_f) prod_f.push_back(f.get().multiplyAsync(three));
+
+  std::vector<std::future<ipcl::PlainText>> dt_f;
+  for (auto& f : prod_f) dt_f.push_back(key.priv_key.decryptAsync(f.get()));
+
+  for (int j = 0; j < num_batches; j++) {
+    ipcl::PlainText dt = dt_f[j].get();
+    for (int i = 0; i < num_values; i++) {
+      std::vector<uint32_t> v = dt.getElementVec(i);
+      EXPECT_EQ(v[0], exp_value[j][i] * 3);
+    }
+  }
+
+  // errors are delivered through the future
+  ipcl::PrivateKey empty_key;
+  auto err_f = empty_key.decryptAsync(
+      key.pub_key.encrypt(ipcl::PlainText(exp_value[0])));
+  EXPECT_THROW(err_f.get(), std::exception);
+}
+
+TEST(CryptoTest, HybridAdaptiveTest) {
+  const std::size_t num_values = 64;
+  const int num_rounds = 8;
+
+  // Slow stand-in accelerator, the controller should move work to the CPU
+  ipcl::setHybridAccelerator(ipcl::makeEmulatedAccelerator(
+      std::chrono::microseconds(0), std::chrono::microseconds(2000)));
+  ipcl::setHybridMode(ipcl::HybridMode::ADAPTIVE);
+
+  ipcl::HybridController& controller = ipcl::HybridController::getInstance();
+  controller.reset();
+  float init_ratio = controller.getRatio(ipcl::HybridOp::OTHER, num_values);
+
+  BigNumber mod = ipcl::getRandomBN(1024) * 2 + 1;
+  std::vector<BigNumber> base(num_values), exp(num_values);
+  for (int i = 0; i < num_values; i++) {
+    base[i] = ipcl::getRandomBN(1000);
+    exp[i] = ipcl::getRandomBN(512);
+  }
+  std::vector<BigNumber> expected = ipcl::ippModExp(base, exp, mod);
+
+  for (int r = 0; r < num_rounds; r++) {
+    std::vector<BigNumber> res = ipcl::modExp(base, exp, mod);
+    for (int i = 0; i < num_values; i++) EXPECT_EQ(res[i], expected[i]);
+  }
+
+  float ratio = controller.getRatio(ipcl::HybridOp::OTHER, num_values);
+  EXPECT_LT(ratio, init_ratio);
+  EXPECT_LT(ratio, 0.5);
+  EXPECT_GT(ratio, 0.0);
+
+  ipcl::setHybridAccelerator(nullptr);
+  ipcl::setHybridMode(ipcl::HybridMode::OPTIMAL);
+}
+
 TEST(CryptoTest, ISO_IEC_18033_6_ComplianceTest) {
   // Ensure that at least 2 different numbers are encrypted
   // Because ir_bn_v[1] will set to a specific value
@@ -186,3 +274,634 @@ TEST(CryptoTest, ISO_IEC_18033_6_ComplianceTest) {
   m1m2.num2hex(str4);
   EXPECT_EQ(str4, dt_sum.getElementHex(0));
 }
+
+TEST(CryptoTest, FixedBaseModExpTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048, true);
+  BigNumber nsq = *(key.pub_key.getNSQ());
+  BigNumber base = key.pub_key.getHS();
+  int max_exp_bits = key.pub_key.getRandBits();
+
+  ipcl::FixedBaseModExp table(base, nsq, max_exp_bits);
+
+  std::vector<BigNumber> exp_bn_v(num_values);
+  for (int i = 0; i < num_values; i++)
+    exp_bn_v[i] = ipcl::getRandomBN(max_exp_bits);
+  exp_bn_v[0] = BigNumber::Zero();
+  exp_bn_v[1] = BigNumber::One();
+  exp_bn_v[2] = ipcl::getRandomBN(max_exp_bits + 64);  // beyond the table
+
+  std::vector<BigNumber> res = table.exp(exp_bn_v);
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(res[i], ipcl::modExp(base, exp_bn_v[i], nsq));
+  }
+}
+
+TEST(CryptoTest, FixedExpModExpTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048, true);
+  BigNumber nsq = *(key.pub_key.getNSQ());
+
+  std::vector<BigNumber> base_bn_v(num_values);
+  for (int i = 0; i < num_values; i++)
+    base_bn_v[i] = ipcl::getRandomBN(2048);
+  base_bn_v[0] = BigNumber::Zero();
+  base_bn_v[1] = BigNumber::One();
+
+  std::vector<BigNumber> exps = {BigNumber::Zero(), BigNumber::One(),
+                                 BigNumber(0x80000001u), ipcl::getRandomBN(64),
+                                 *(key.pub_key.getN())};
+  for (const auto& exp : exps) {
+    ipcl::FixedExpModExp engine(exp, nsq);
+    std::vector<BigNumber> res = engine.exp(base_bn_v);
+    for (int i = 0; i < num_values; i++) {
+      EXPECT_EQ(res[i], ipcl::modExp(base_bn_v[i], exp, nsq));
+    }
+  }
+}
+
+TEST(CryptoTest, ModExpTest) {
+  // more moduli than the per-thread Montgomery engine cache holds
+  const int num_mods = 2 * ipcl::IPCL_MONT_CACHE_SIZE;
+  const int exp_bits[] = {16, 512};
+
+  std::vector<BigNumber> mods(num_mods);
+  for (auto& mod : mods) mod = ipcl::getRandomBN(1024) * 2 + 1;
+
+  // The first two rounds cycle through all the moduli and evict the least
+  // recently used engines. The last rounds stay on the last moduli, whose
+  // engines (one per exponentiation method) all fit in the cache and must be
+  // reused.
+  const int num_cached = ipcl::IPCL_MONT_CACHE_SIZE / 2;
+  std::vector<IppsMontState*> states(num_mods, nullptr);
+  for (int round = 0; round < 4; round++) {
+    int first = (round < 2) ? 0 : num_mods - num_cached;
+    for (int i = first; i < num_mods; i++) {
+      const BigNumber& mod = mods[i];
+      BigNumber base = ipcl::getRandomBN(1000);
+      for (int bits : exp_bits) {
+        BigNumber exp = ipcl::getRandomBN(bits);
+
+        BigNumber expected = BigNumber::One();
+        for (int j = exp.BitSize() - 1; j >= 0; j--) {
+          expected = mod.ModMul(expected, expected);
+          if (exp.TestBit(j)) expected = mod.ModMul(expected, base);
+        }
+        EXPECT_EQ(ipcl::modExp(base, exp, mod), expected);
+      }
+
+      IppsMontState* state = ipcl::getMontState(mod);
+      if (round == 3) EXPECT_EQ(state, states[i]);
+      states[i] = state;
+    }
+  }
+}
+
+TEST(CryptoTest, ObfuscatorPoolTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+  const std::size_t capacity = 64;
+  const std::size_t low_water_mark = 16;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048, true);
+  key.pub_key.enableObfuscatorPool(capacity, low_water_mark);
+  auto pool = key.pub_key.getObfuscatorPool();
+  ASSERT_NE(pool, nullptr);
+
+  // wait for the background refill
+  for (int i = 0; i < 1000 && pool->getAvailable() < capacity; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_EQ(pool->getAvailable(), capacity);
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+  for (int i = 0; i < num_values; i++) exp_value[i] = dist(rng);
+
+  ipcl::PlainText pt = ipcl::PlainText(exp_value);
+  ipcl::CipherText ct = key.pub_key.encrypt(pt);
+  EXPECT_EQ(pool->getAvailable(), capacity - num_values);
+
+  ipcl::PlainText dt = key.priv_key.decrypt(ct);
+  for (int i = 0; i < num_values; i++) {
+    std::vector<uint32_t> v = dt.getElementVec(i);
+    EXPECT_EQ(v[0], exp_value[i]);
+  }
+
+  // drain the pool, missing obfuscators are computed inline
+  std::vector<uint32_t> big_value(capacity * 2, 7);
+  ct = key.pub_key.encrypt(ipcl::PlainText(big_value));
+  dt = key.priv_key.decrypt(ct);
+  for (int i = 0; i < big_value.size(); i++)
+    EXPECT_EQ(dt.getElementVec(i)[0], big_value[i]);
+
+  key.pub_key.disableObfuscatorPool();
+  EXPECT_EQ(key.pub_key.getObfuscatorPool(), nullptr);
+}
+
+TEST(CryptoTest, ObfuscatorPoolFailureTest) {
+  // a failing generator is reported by acquire instead of silently stopping
+  // the refill
+  ipcl::ObfuscatorPool pool(
+      [](std::size_t) -> std::vector<BigNumber> {
+        throw std::runtime_error("generator failure");
+      },
+      64, 16);
+
+  bool thrown = false;
+  for (int i = 0; i < 1000 && !thrown; i++) {
+    try {
+      pool.acquire(1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+  }
+  EXPECT_TRUE(thrown);
+  EXPECT_THROW(pool.acquire(1), std::runtime_error);
+}
+
+TEST(CryptoTest, ObfuscatorPoolRefillTest) {
+  // concurrent refill threads generate no more than the pool can take
+  const std::size_t capacity = 64;
+  std::atomic<std::size_t> generated(0);
+  ipcl::ObfuscatorPool pool(
+      [&generated](std::size_t sz) {
+        generated += sz;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return std::vector<BigNumber>(sz, BigNumber::One());
+      },
+      capacity, 16, 4);
+
+  for (int i = 0; i < 1000 && pool.getAvailable() < capacity; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_EQ(pool.getAvailable(), capacity);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(generated, capacity);
+
+  // a drained pool is refilled by exactly the missing count
+  EXPECT_EQ(pool.acquire(capacity - 8).size(), capacity - 8);
+  for (int i = 0; i < 1000 && pool.getAvailable() < capacity; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_EQ(pool.getAvailable(), capacity);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(generated, 2 * capacity - 8);
+}
+
+TEST(CryptoTest, MoveTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048, true);
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+  for (int i = 0; i < num_values; i++) exp_value[i] = dist(rng);
+
+  std::vector<BigNumber> bn_v(exp_value.begin(), exp_value.end());
+  const BigNumber* data = bn_v.data();
+  ipcl::PlainText pt(std::move(bn_v));
+  EXPECT_EQ(pt.getTexts().data(), data);
+
+  ipcl::CipherText ct = key.pub_key.encrypt(pt);
+  ipcl::CipherText moved_ct(std::move(ct));
+  EXPECT_EQ(ct.getSize(), 0);
+  ASSERT_EQ(moved_ct.getSize(), num_values);
+
+  ipcl::PlainText dt;
+  dt = key.priv_key.decrypt(moved_ct);
+  const std::vector<BigNumber>& dt_v = dt.getTexts();
+  for (int i = 0; i < num_values; i++)
+    EXPECT_EQ(dt_v[i], BigNumber(exp_value[i]));
+
+  // a moved-from big number is a usable zero
+  BigNumber bn(exp_value[0]);
+  BigNumber moved_bn(std::move(bn));
+  EXPECT_EQ(moved_bn, BigNumber(exp_value[0]));
+  EXPECT_EQ(bn, BigNumber::Zero());
+  bn += moved_bn;
+  EXPECT_EQ(bn, moved_bn);
+
+  // moving leaves no state behind to allocate or release
+  BigNumber moved_again(std::move(moved_bn));
+  moved_bn = std::move(moved_again);
+  EXPECT_EQ(moved_bn, bn);
+  EXPECT_EQ(moved_again, BigNumber::Zero());
+  moved_again = bn;
+  EXPECT_EQ(moved_again, bn);
+}
+
+TEST(CryptoTest, BigNumberPoolTest) {
+  std::vector<Ipp32u> words(1024);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  for (Ipp32u& w : words) w = rng() | 0x80000001;
+
+  // hold the whole depth of the 8-word class, so that it is empty and keeps
+  // the states released below
+  std::vector<BigNumber> held(ipcl::IPCL_BIGNUM_POOL_DEPTH,
+                              BigNumber(words.data(), 8));
+
+  // a released state goes to the next number of its size class only
+  const IppsBigNumState* state;
+  {
+    BigNumber a(words.data(), 5);
+    state = BN(a);
+  }
+  {
+    BigNumber b(words.data(), 16);
+    BigNumber c(words.data(), 3);
+    EXPECT_NE(BN(b), state);
+    EXPECT_NE(BN(c), state);
+    BigNumber d(words.data(), 8);
+    EXPECT_EQ(BN(d), state);
+    EXPECT_EQ(d, held[0]);
+  }
+
+  // lengths above the largest class bypass the pool
+  BigNumber huge(words.data(), 1024);
+  EXPECT_EQ(huge.BitSize(), 1024 * 32);
+  EXPECT_EQ(huge - huge, BigNumber::Zero());
+
+  // assignment reuses the buffer when the value fits in it
+  BigNumber x(words.data(), 16);
+  const IppsBigNumState* x_state = BN(x);
+  BigNumber small(words.data(), 4, IppsBigNumNEG);
+  x = small;
+  EXPECT_EQ(BN(x), x_state);
+  EXPECT_EQ(x, small);
+  EXPECT_EQ(x + BigNumber::One(), small + BigNumber::One());
+
+  // a larger value than the buffer gets a new state
+  BigNumber large(words.data(), 32);
+  x = large;
+  int room;
+  ippsGetSize_BN(BN(x), &room);
+  EXPECT_GE(room, 32);
+  EXPECT_EQ(x, large);
+
+  // a smaller value in a larger buffer does not read the stale high words
+  x = small;
+  EXPECT_EQ(x, small);
+  x = BigNumber::Zero();
+  EXPECT_EQ(x, BigNumber::Zero());
+  EXPECT_EQ(x + large, large);
+
+  BigNumber y(words.data(), 1);
+  y = large;
+  EXPECT_EQ(y, large);
+  y = huge;
+  EXPECT_EQ(y, huge);
+}
+
+TEST(CryptoTest, PackedModExpTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048, true);
+  const BigNumber& nsq = *key.pub_key.getNSQ();
+
+  std::vector<BigNumber> base(num_values), exp(num_values);
+  for (int i = 0; i < num_values; i++) {
+    base[i] = ipcl::getRandomBN(4000);
+    exp[i] = ipcl::getRandomBN(1024);
+  }
+
+  ipcl::PackedBigNumbers packed_base(base, nsq.BitSize());
+  EXPECT_EQ(packed_base.getStride() % 8, 0);
+  EXPECT_EQ(packed_base.unpack(), base);
+
+  std::vector<BigNumber> expected = ipcl::modExp(base, exp, nsq);
+  ipcl::PackedBigNumbers res =
+      ipcl::modExp(packed_base, ipcl::PackedBigNumbers(exp), nsq);
+  EXPECT_EQ(res.unpack(), expected);
+
+  expected = ipcl::modExp(base, exp[0], nsq);
+  res = ipcl::modExp(packed_base, exp[0], nsq);
+  EXPECT_EQ(res.unpack(), expected);
+
+  // pows wider than the modulus are rejected
+  ipcl::PackedBigNumbers wide_exp(num_values, nsq.BitSize() + 64);
+  EXPECT_THROW(ipcl::modExp(packed_base, wide_exp, nsq), std::runtime_error);
+}
+
+TEST(CryptoTest, ModMulTest) {
+  // moduli of the key sizes, past the 8-lane kernel limit, and of digit
+  // counts off the 52-bit grid after longer ones reusing the workspace
+  const int mod_bits[] = {1024, 2048, 4096, 8192, 8300, 1041, 3119};
+  const int v_sizes[] = {1, 8, 13};
+
+  for (int bits : mod_bits) {
+    BigNumber mod = ipcl::getRandomBN(bits - 1) + ipcl::getRandomBN(bits - 1);
+    if (!mod.IsOdd()) mod += 1;
+
+    for (int v_size : v_sizes) {
+      std::vector<BigNumber> a(v_size), b(v_size);
+      for (int i = 0; i < v_size; i++) {
+        a[i] = ipcl::getRandomBN(bits) % mod;
+        b[i] = ipcl::getRandomBN(bits) % mod;
+      }
+      // corner operands
+      a[0] = mod - BigNumber::One();
+      b[0] = mod + BigNumber::Two();
+      b[v_size - 1] = BigNumber::Zero();
+
+      std::vector<BigNumber> res = ipcl::modMul(a, b, mod);
+      std::vector<BigNumber> res_scalar = ipcl::modMul(a, {b[0]}, mod);
+      ASSERT_EQ(res.size(), v_size);
+      ASSERT_EQ(res_scalar.size(), v_size);
+      for (int i = 0; i < v_size; i++) {
+        EXPECT_EQ(res[i], mod.ModMul(a[i], b[i]));
+        EXPECT_EQ(res_scalar[i], mod.ModMul(a[i], b[0]));
+      }
+
+      // double-width operands below mod^2 as CT + PT passes them, past
+      // mod * R, and negative
+      for (int i = 0; i < v_size; i++)
+        a[i] = ipcl::getRandomBN(2 * bits) % (mod * mod);
+      a[0] = mod * mod - BigNumber::One();
+      a[v_size - 1] = ipcl::getRandomBN(2 * bits + 64);
+      if (v_size > 1) a[1] = BigNumber::Zero() - a[1];
+
+      res = ipcl::modMul(a, b, mod);
+      res_scalar = ipcl::modMul(a, {b[0]}, mod);
+      for (int i = 0; i < v_size; i++) {
+        EXPECT_EQ(res[i], a[i] * b[i] % mod);
+        EXPECT_EQ(res_scalar[i], a[i] * b[0] % mod);
+      }
+    }
+  }
+}
+
+TEST(CryptoTest, EncoderTest) {
+  const std::size_t num_values = 100;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<int64_t> dist(INT32_MIN, INT32_MAX);
+
+  // signed integers, sums and small products stay within the headroom
+  ipcl::Encoder encoder(key.pub_key, 32, 16);
+  EXPECT_EQ(encoder.getSlotBits(), 48);
+  EXPECT_EQ(encoder.getSlotsPerElement(), 2047 / 48);
+
+  std::vector<int64_t> x(num_values), y(num_values);
+  for (std::size_t i = 0; i < num_values; i++) {
+    x[i] = dist(rng);
+    y[i] = dist(rng);
+  }
+  x[0] = INT32_MIN;
+  y[0] = INT32_MIN;
+
+  ipcl::PlainText pt_x = encoder.encode(x);
+  EXPECT_EQ(pt_x.getSize(), (num_values + 41) / 42);
+
+  ipcl::CipherText ct_x = key.pub_key.encrypt(pt_x);
+  ipcl::CipherText ct_y = key.pub_key.encrypt(encoder.encode(y));
+  ipcl::CipherText ct_res = (ct_x + ct_y) * ipcl::PlainText(3);
+
+  std::vector<int64_t> dt_x =
+      encoder.decodeInt(key.priv_key.decrypt(ct_x), num_values);
+  std::vector<int64_t> dt_res =
+      encoder.decodeInt(key.priv_key.decrypt(ct_res), num_values);
+  for (std::size_t i = 0; i < num_values; i++) {
+    EXPECT_EQ(dt_x[i], x[i]);
+    EXPECT_EQ(dt_res[i], (x[i] + y[i]) * 3);
+  }
+
+  // fixed-point values
+  ipcl::Encoder fp_encoder(key.pub_key, 40, 8, 16);
+  std::uniform_real_distribution<double> fp_dist(-1000.0, 1000.0);
+  std::vector<double> f(num_values), g(num_values);
+  for (std::size_t i = 0; i < num_values; i++) {
+    f[i] = fp_dist(rng);
+    g[i] = fp_dist(rng);
+  }
+
+  ipcl::CipherText ct_f = key.pub_key.encrypt(fp_encoder.encode(f));
+  ipcl::CipherText ct_fg = ct_f + fp_encoder.encode(g);
+  std::vector<double> dt_fg =
+      fp_encoder.decodeDouble(key.priv_key.decrypt(ct_fg), num_values);
+  for (std::size_t i = 0; i < num_values; i++)
+    EXPECT_NEAR(dt_fg[i], f[i] + g[i], 1.0 / (1 << 15));
+
+  EXPECT_THROW(encoder.encode(std::vector<int64_t>{INT64_C(1) << 31}),
+               std::runtime_error);
+  EXPECT_THROW(ipcl::Encoder(key.pub_key, 48, 16), std::runtime_error);
+}
+
+TEST(CryptoTest, CRTDecryptTest) {
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+  ipcl::PrivateKey raw_key = key.priv_key;
+  raw_key.enableCRT(false);
+
+  // batches filling the lanes partially and fully, with tails of the p and q
+  // halves that share a chunk or not
+  for (int num_values : {1, 3, 4, 5, 9, 12, 17}) {
+    std::vector<BigNumber> bn_v(num_values);
+    for (int i = 0; i < num_values; i++) bn_v[i] = ipcl::getRandomBN(2000);
+    bn_v[0] = BigNumber::Zero();
+
+    ipcl::PlainText pt(bn_v);
+    ipcl::CipherText ct = key.pub_key.encrypt(pt);
+    ipcl::PlainText dt = key.priv_key.decrypt(ct);
+    ipcl::PlainText dt_raw = raw_key.decrypt(ct);
+
+    for (int i = 0; i < num_values; i++) {
+      EXPECT_EQ(dt.getElement(i), bn_v[i]);
+      EXPECT_EQ(dt_raw.getElement(i), bn_v[i]);
+    }
+  }
+
+  // halves of different sizes and moduli
+  BigNumber mod_p = ipcl::getRandomBN(2048) + BigNumber::One();
+  BigNumber mod_q = ipcl::getRandomBN(1500) + BigNumber::One();
+  if (!mod_p.IsOdd()) mod_p += 1;
+  if (!mod_q.IsOdd()) mod_q += 1;
+  BigNumber exp_p = ipcl::getRandomBN(1024), exp_q = ipcl::getRandomBN(700);
+  for (int q_size : {1, 6, 11}) {
+    std::vector<BigNumber> base_p = ipcl::getRandomBNBelow(3, mod_p);
+    std::vector<BigNumber> base_q = ipcl::getRandomBNBelow(q_size, mod_q);
+    std::vector<BigNumber> res_p, res_q;
+    ipcl::modExpCRT(res_p, res_q, base_p, exp_p, mod_p, base_q, exp_q, mod_q);
+    EXPECT_EQ(res_p, ipcl::modExp(base_p, exp_p, mod_p));
+    EXPECT_EQ(res_q, ipcl::modExp(base_q, exp_q, mod_q));
+  }
+}
+
+TEST(CryptoTest, PrivateKeyEncryptTest) {
+  const uint32_t num_values = 17;
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+  ipcl::PrivateKey raw_key = key.priv_key;
+  raw_key.enableCRT(false);
+
+  std::vector<BigNumber> bn_v(num_values);
+  for (int i = 0; i < num_values; i++) bn_v[i] = ipcl::getRandomBN(2000);
+  bn_v[0] = BigNumber::Zero();
+  ipcl::PlainText pt(bn_v);
+
+  ipcl::CipherText ct = key.priv_key.encrypt(pt);
+  ipcl::PlainText dt = key.priv_key.decrypt(ct);
+  ipcl::PlainText dt_raw = raw_key.decrypt(ct);
+
+  // the ciphertexts mix with the ones of the public key
+  ipcl::CipherText ct_sum = ct + key.pub_key.encrypt(pt);
+  ipcl::PlainText dt_sum = key.priv_key.decrypt(ct_sum);
+
+  ipcl::CipherText ct_plain = key.priv_key.encrypt(pt, false);
+  ipcl::CipherText ct_plain_pub = key.pub_key.encrypt(pt, false);
+
+  BigNumber n = *key.pub_key.getN();
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(dt.getElement(i), bn_v[i]);
+    EXPECT_EQ(dt_raw.getElement(i), bn_v[i]);
+    EXPECT_EQ(dt_sum.getElement(i), (bn_v[i] + bn_v[i]) % n);
+    EXPECT_EQ(ct_plain.getElement(i), ct_plain_pub.getElement(i));
+  }
+}
+
+TEST(CryptoTest, WideModExpTest) {
+  // moduli beyond the mbx_exp_mb8 limit, on and off the 52-bit digit grid
+  const int mod_bits[] = {6144, 8192, 4201};
+  const int v_sizes[] = {3, 8, 11};
+
+  for (int bits : mod_bits) {
+    BigNumber mod = ipcl::getRandomBN(bits - 1) + ipcl::getRandomBN(bits - 1);
+    if (!mod.IsOdd()) mod += 1;
+
+    for (int v_size : v_sizes) {
+      std::vector<BigNumber> base(v_size), exp(v_size);
+      for (int i = 0; i < v_size; i++) {
+        base[i] = ipcl::getRandomBN(bits) % mod;
+        exp[i] = ipcl::getRandomBN(bits / 2 + 7 * i);
+      }
+      // corner operands
+      base[0] = mod - BigNumber::One();
+      exp[0] = BigNumber::Zero();
+      exp[1] = BigNumber::One();
+
+      std::vector<BigNumber> res = ipcl::modExp(base, exp, mod);
+      std::vector<BigNumber> res_shared = ipcl::modExp(base, exp[2], mod);
+      ASSERT_EQ(res.size(), v_size);
+      for (int i = 0; i < v_size; i++) {
+        EXPECT_EQ(res[i], ipcl::ippModExp(base[i], exp[i], mod));
+        EXPECT_EQ(res_shared[i], ipcl::ippModExp(base[i], exp[2], mod));
+      }
+    }
+  }
+}
+
+TEST(CryptoTest, Key3072Test) {
+  const uint32_t num_values = 9;
+  ipcl::KeyPair key = ipcl::generateKeypair(3072, true);
+  ipcl::PrivateKey raw_key = key.priv_key;
+  raw_key.enableCRT(false);
+
+  std::vector<BigNumber> bn_v(num_values);
+  for (int i = 0; i < num_values; i++) bn_v[i] = ipcl::getRandomBN(3000);
+  ipcl::PlainText pt(bn_v);
+
+  ipcl::CipherText ct = key.pub_key.encrypt(pt);
+  ipcl::PlainText dt = key.priv_key.decrypt(ct);
+  ipcl::PlainText dt_raw = raw_key.decrypt(ct);
+  ipcl::PlainText dt_sum = key.priv_key.decrypt(ct + ct);
+
+  BigNumber n = *key.pub_key.getN();
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(dt.getElement(i), bn_v[i]);
+    EXPECT_EQ(dt_raw.getElement(i), bn_v[i]);
+    EXPECT_EQ(dt_sum.getElement(i), (bn_v[i] + bn_v[i]) % n);
+  }
+}
+
+TEST(CryptoTest, KeyGenTest) {
+  // Fermat test in base 2
+  auto is_probable_prime = [](const BigNumber& p) {
+    return ipcl::ippModExp(BigNumber::Two(), p - 1, p) == BigNumber::One();
+  };
+
+  for (int bits : {24, 256, 1024}) {
+    BigNumber prime = ipcl::getPrimeBN(bits);
+    EXPECT_EQ(prime.BitSize(), bits);
+    EXPECT_TRUE(is_probable_prime(prime));
+  }
+
+  for (bool enable_DJN : {false, true}) {
+    ipcl::KeyPair key = ipcl::generateKeypair(1024, enable_DJN);
+    BigNumber p = *key.priv_key.getP();
+    BigNumber q = *key.priv_key.getQ();
+
+    EXPECT_EQ((*key.pub_key.getN()).BitSize(), 1024);
+    EXPECT_TRUE(is_probable_prime(p));
+    EXPECT_TRUE(is_probable_prime(q));
+    if (enable_DJN) {
+      EXPECT_TRUE(p.TestBit(1) && q.TestBit(1));  // p = q = 3 mod 4
+      EXPECT_EQ((p - 1).gcd(q - 1), BigNumber::Two());
+    }
+  }
+}
+
+TEST(CryptoTest, RandomBNTest) {
+  const int num_values = 1000;
+
+  // bit lengths on and off the word grid
+  for (int bits : {1, 31, 64, 2048}) {
+    std::vector<BigNumber> r = ipcl::getRandomBNs(num_values, bits);
+    ASSERT_EQ(r.size(), num_values);
+    int top_set = 0;
+    for (const BigNumber& v : r) {
+      EXPECT_LE(v.BitSize(), bits);
+      top_set += v.TestBit(bits - 1);
+    }
+    // the top bit is set about half of the time
+    EXPECT_GT(top_set, num_values / 2 - 100);
+    EXPECT_LT(top_set, num_values / 2 + 100);
+  }
+
+  // a tiny bound and key sized bounds
+  BigNumber small_bound(static_cast<Ipp32u>(3));
+  ipcl::KeyPair key = ipcl::generateKeypair(1024);
+  BigNumber n = *key.pub_key.getN();
+  for (const BigNumber& bound : {small_bound, n, n + BigNumber::One()}) {
+    std::vector<BigNumber> r = ipcl::getRandomBNBelow(num_values, bound);
+    ASSERT_EQ(r.size(), num_values);
+    for (const BigNumber& v : r) {
+      EXPECT_GE(v, BigNumber::One());
+      EXPECT_LT(v, bound);
+    }
+  }
+  std::vector<BigNumber> r = ipcl::getRandomBNBelow(num_values, small_bound);
+  EXPECT_NE(std::count(r.begin(), r.end(), BigNumber::One()), 0);
+  EXPECT_NE(std::count(r.begin(), r.end(), BigNumber::Two()), 0);
+}
+
+TEST(CryptoTest, DRBGForkTest) {
+  // leave buffered output in the generator of this thread
+  ipcl::DRBG& drbg = ipcl::DRBG::getInstance();
+  std::array<Ipp32u, 8> parent, child;
+  drbg.generate(parent.data(), parent.size());
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    drbg.generate(child.data(), child.size());
+    ssize_t written = write(fds[1], child.data(), sizeof(child));
+    _exit(written == sizeof(child) ? 0 : 1);
+  }
+  close(fds[1]);
+  ASSERT_EQ(read(fds[0], child.data(), sizeof(child)), sizeof(child));
+  close(fds[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  EXPECT_EQ(status, 0);
+
+  // the child reseeds instead of replaying the next output of the parent
+  drbg.generate(parent.data(), parent.size());
+  EXPECT_NE(parent, child);
+}
@@ -1,6 +1,7 @@
 // Copyright (C) 2021 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <climits>
 #include <random>
 #include <vector>
@@ -406,6 +407,32 @@ TEST(OperationTest, CtMultiplyPtArrayTest) {
   }
 }
 
+TEST(OperationTest, CtMultiplyScalarPtTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+  for (int i = 0; i < num_values; i++) exp_value[i] = dist(rng);
+  uint32_t scalar = dist(rng);
+
+  // a single plaintext multiplies every element with one shared pow
+  ipcl::CipherText ct = key.pub_key.encrypt(ipcl::PlainText(exp_value));
+  ipcl::CipherText ct_product = ct * ipcl::PlainText(scalar);
+  ipcl::PlainText dt_product = key.priv_key.decrypt(ct_product);
+
+  for (int i = 0; i < num_values; i++) {
+    std::vector<uint32_t> v = dt_product.getElementVec(i);
+    uint64_t product = v[0];
+    if (v.size() > 1) product = ((uint64_t)v[1] << 32) | v[0];
+
+    EXPECT_EQ(product, (uint64_t)exp_value[i] * (uint64_t)scalar);
+  }
+}
+
 TEST(OperationTest, AddSubTest) {
   const uint32_t num_values = SELF_DEF_NUM_VALUES;
   const float qat_ratio = SELF_DEF_HYBRID_QAT_RATIO;
@@ -606,3 +633,208 @@ TEST(OperationTest, PtMultiplyCtArrayTest) {
     EXPECT_EQ(product, exp_product);
   }
 }
+
+TEST(OperationTest, KeyHandleTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+  ipcl::PublicKey pub_key_copy = key.pub_key;
+
+  std::vector<uint32_t> exp_value(num_values, 1);
+  ipcl::PlainText pt = ipcl::PlainText(exp_value);
+
+  const BigNumber& n = *key.pub_key.getN();
+  ipcl::PublicKey djn_key(n, 2048);
+  djn_key.setDJN(key.pub_key.getHS(), key.pub_key.getRandBits());
+
+  ipcl::CipherText ct1 = key.pub_key.encrypt(pt);
+  ipcl::CipherText ct2 = pub_key_copy.encrypt(pt);
+  ipcl::CipherText ct3(djn_key, ct1.getTexts());
+
+  // ciphertexts of keys with the same parameters share one key handle
+  EXPECT_EQ(ct1.getPubKey(), key.pub_key.getHandle());
+  EXPECT_EQ(ct2.getPubKey(), ct1.getPubKey());
+  EXPECT_EQ(ct3.getPubKey(), ct1.getPubKey());
+  EXPECT_EQ(ct1.getCipherText(0).getPubKey(), ct1.getPubKey());
+  EXPECT_EQ((ct1 + ct2).getPubKey(), ct1.getPubKey());
+  EXPECT_EQ((ct1 * pt).getPubKey(), ct1.getPubKey());
+
+  // the handle follows changes of the DJN parameters
+  ipcl::PublicKey plain_key(n, 2048);
+  EXPECT_FALSE(plain_key.getHandle()->isDJN());
+  EXPECT_NE(plain_key.getHandle(), ct1.getPubKey());
+  plain_key.enableDJN();
+  EXPECT_TRUE(plain_key.getHandle()->isDJN());
+  EXPECT_EQ(plain_key.getHandle()->getHS(), plain_key.getHS());
+  djn_key.setHS(plain_key.getHS());
+  EXPECT_EQ(djn_key.getHandle(), plain_key.getHandle());
+  EXPECT_NE(djn_key.getHandle(), ct1.getPubKey());
+
+  // ciphertexts of the same n still combine across DJN parameters
+  ipcl::CipherText ct4(plain_key, ct1.getTexts());
+  ipcl::PlainText dt = key.priv_key.decrypt(ct1 + ct4);
+  for (int i = 0; i < num_values; i++)
+    EXPECT_EQ(dt.getElement(i), BigNumber(2));
+
+  ipcl::KeyPair other_key = ipcl::generateKeypair(2048);
+  ipcl::CipherText other_ct = other_key.pub_key.encrypt(pt);
+  EXPECT_NE(other_ct.getPubKey(), ct1.getPubKey());
+  EXPECT_THROW(ct1 + other_ct, std::runtime_error);
+}
+
+TEST(OperationTest, InnerProductTest) {
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+
+  // the larger size is split across threads
+  for (uint32_t num_values : {1u, 14u, 300u}) {
+    std::vector<uint32_t> exp_value1(num_values), exp_value2(num_values);
+    BigNumber expected = BigNumber::Zero();
+    for (int i = 0; i < num_values; i++) {
+      exp_value1[i] = dist(rng);
+      exp_value2[i] = (i == 0) ? 0 : dist(rng);  // zero weight
+      expected += BigNumber(exp_value1[i]) * BigNumber(exp_value2[i]);
+    }
+
+    ipcl::PlainText pt1 = ipcl::PlainText(exp_value1);
+    ipcl::PlainText pt2 = ipcl::PlainText(exp_value2);
+    ipcl::CipherText ct1 = key.pub_key.encrypt(pt1);
+
+    ipcl::CipherText ct_res = ipcl::innerProduct(ct1, pt2);
+    ipcl::PlainText dt_res = key.priv_key.decrypt(ct_res);
+
+    EXPECT_EQ(ct_res.getSize(), 1);
+    EXPECT_EQ(dt_res.getElement(0), expected);
+  }
+
+  ipcl::CipherText ct = key.pub_key.encrypt(ipcl::PlainText(1));
+  ipcl::PlainText pt(std::vector<uint32_t>(2, 1));
+  EXPECT_THROW(ipcl::innerProduct(ct, pt), std::runtime_error);
+}
+
+TEST(OperationTest, CtSumTest) {
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+
+  // the larger size is split into parts reduced across threads
+  for (uint32_t num_values : {1u, 14u, 1000u}) {
+    std::vector<uint32_t> exp_value(num_values);
+    for (int i = 0; i < num_values; i++) exp_value[i] = dist(rng);
+
+    ipcl::PlainText pt = ipcl::PlainText(exp_value);
+    ipcl::CipherText ct = key.pub_key.encrypt(pt);
+
+    for (std::size_t block_size : {1ul, 3ul, 256ul, 1ul << 20}) {
+      ipcl::CipherText ct_res = ct.sum(block_size);
+      ipcl::PlainText dt_res = key.priv_key.decrypt(ct_res);
+
+      std::size_t num_blocks = (num_values + block_size - 1) / block_size;
+      ASSERT_EQ(ct_res.getSize(), num_blocks);
+      for (std::size_t j = 0; j < num_blocks; j++) {
+        BigNumber expected = BigNumber::Zero();
+        for (std::size_t i = j * block_size;
+             i < std::min<std::size_t>((j + 1) * block_size, num_values); i++)
+          expected += BigNumber(exp_value[i]);
+        EXPECT_EQ(dt_res.getElement(j), expected);
+      }
+    }
+
+    BigNumber expected = BigNumber::Zero();
+    for (int i = 0; i < num_values; i++) expected += BigNumber(exp_value[i]);
+    ipcl::PlainText dt_sum = key.priv_key.decrypt(ct.sum());
+    EXPECT_EQ(dt_sum.getElement(0), expected);
+  }
+
+  EXPECT_THROW(ipcl::CipherText().sum(), std::runtime_error);
+}
+
+TEST(OperationTest, MontgomeryDomainTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+
+  std::vector<uint32_t> exp_value1(num_values), exp_value2(num_values);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+
+  for (int i = 0; i < num_values; i++) {
+    exp_value1[i] = dist(rng);
+    exp_value2[i] = dist(rng);
+  }
+
+  ipcl::PlainText pt1 = ipcl::PlainText(exp_value1);
+  ipcl::PlainText pt2 = ipcl::PlainText(exp_value2);
+  ipcl::CipherText ct1 = key.pub_key.encrypt(pt1);
+  ipcl::CipherText ct2 = key.pub_key.encrypt(pt2);
+
+  ipcl::CipherText ct1_m = ct1.toMontgomery();
+  ipcl::CipherText ct2_m = ct2.toMontgomery();
+  EXPECT_TRUE(ct1_m.isMontgomery());
+  EXPECT_FALSE(ct1_m.fromMontgomery().isMontgomery());
+
+  // CT+CT and sums stay in the domain and match the standard results
+  ipcl::CipherText ct_sum = ct1 + ct2;
+  ipcl::CipherText ct_sum_m = ct1_m + ct2_m;
+  EXPECT_TRUE(ct_sum_m.isMontgomery());
+  EXPECT_EQ(ct_sum_m.fromMontgomery().getTexts(), ct_sum.getTexts());
+  EXPECT_EQ((ct1_m + ct2).fromMontgomery().getTexts(), ct_sum.getTexts());
+  EXPECT_EQ(ct1_m.sum().fromMontgomery().getTexts(), ct1.sum().getTexts());
+
+  // chained operations decrypt in either domain
+  ipcl::CipherText ct_res = ((ct1_m + pt2) * pt2).rotate(1) + ct2_m;
+  EXPECT_TRUE(ct_res.isMontgomery());
+  ipcl::PlainText dt_res = key.priv_key.decrypt(ct_res);
+
+  for (int i = 0; i < num_values; i++) {
+    int j = (i + num_values - 1) % num_values;
+    BigNumber expected =
+        (BigNumber(exp_value1[j]) + BigNumber(exp_value2[j])) *
+            BigNumber(exp_value2[j]) +
+        BigNumber(exp_value2[i]);
+    EXPECT_EQ(dt_res.getElement(i), expected);
+  }
+}
+
+TEST(OperationTest, CtPlusPtEncodingTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+  const BigNumber& n = *key.pub_key.getN();
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+  for (int i = 0; i < num_values; i++) exp_value[i] = dist(rng);
+
+  // offsets wrapping around n, negative ones included
+  std::vector<BigNumber> offset(num_values);
+  for (int i = 0; i < num_values; i++)
+    offset[i] = (i % 2) ? n - BigNumber(i) : n + BigNumber(i);
+  offset[2] = BigNumber::Zero() - BigNumber(2);
+  offset[4] = BigNumber::Zero() - n - BigNumber(4);
+
+  ipcl::PlainText pt = ipcl::PlainText(exp_value);
+  ipcl::PlainText pt_offset = ipcl::PlainText(offset);
+  ipcl::CipherText ct = key.pub_key.encrypt(pt);
+
+  ipcl::CipherText ct_res = ct + pt_offset;
+  ipcl::CipherText ct_res_scalar = ct + ipcl::PlainText(offset[1]);
+  ipcl::CipherText ct_res_ref = ct + key.pub_key.encrypt(pt_offset, false);
+  EXPECT_EQ(ct_res.getTexts(), ct_res_ref.getTexts());
+
+  ipcl::PlainText dt_res = key.priv_key.decrypt(ct_res);
+  ipcl::PlainText dt_res_scalar = key.priv_key.decrypt(ct_res_scalar);
+  for (int i = 0; i < num_values; i++) {
+    BigNumber m = BigNumber(exp_value[i]);
+    EXPECT_EQ(dt_res.getElement(i), (m + offset[i]) % n);
+    EXPECT_EQ(dt_res_scalar.getElement(i), (m + offset[1]) % n);
+  }
+}